@@ -80,8 +80,21 @@ let package = Package(
         // =========================================================
         .testTarget(
             name: "TunForgeTests",
-            dependencies: ["TunForge"],
+            dependencies: ["TunForge", "Lwip"],
             path: "Tests/TunForgeTests"
         ),
+        // Internal ObjC/lwIP units that the Swift surface cannot reach.
+        .testTarget(
+            name: "TunForgeCoreTests",
+            dependencies: ["TunForgeCore", "Lwip"],
+            path: "Tests/TunForgeCoreTests",
+            cSettings: [
+                .headerSearchPath("../../Sources/TunForgeCore"),
+                .headerSearchPath("../../Sources/Lwip/src/include"),
+                .headerSearchPath("../../Sources/Lwip/custom"),
+                .define("LWIP_IOS", .when(platforms: [.iOS])),
+                .define("LWIP_MACOS", .when(platforms: [.macOS])),
+            ]
+        ),
     ]
 )
@@ -96,16 +96,48 @@
 
 #define TUNFORGE_NETIF_IPV4_MTU  1500
 
-#define LWIP_TCP_PCB_NUM_EXT_ARGS 1
+/*
+ * Largest segment tcp_write() builds for large-send (GSO) pcbs.
+ * Must leave room for PBUF_TRANSPORT headers and TCP options within a u16 pbuf.
+ */
+#define TUNFORGE_TCP_GSO_MAX_SEGMENT 60000
+
+/*
+ * Internet checksum: vectorized kernels (tf_chksum.c). lwIP's algorithm #2 stays
+ * compiled as lwip_standard_chksum, the scalar fallback and reference.
+ * tcp_write() copies and sums outbound data in one pass (checksum on copy).
+ */
+#include "tf_chksum.h"
+#define LWIP_CHKSUM                     tf_chksum
+#define LWIP_CHKSUM_ALGORITHM           2
+#define LWIP_CHKSUM_COPY(dst, src, len) tf_chksum_copy(dst, src, len)
+#define LWIP_CHECKSUM_ON_COPY           1
+
+#define LWIP_TCP_PCB_NUM_EXT_ARGS 2
 
 #define TUNFORGE_TCP_EXTARG_ID        0
+#define TUNFORGE_TCP_EXTARG_LEDGER_ID 1 /* no-copy write ledger (TFSendLedger.h) */
+
+/*
+ * Ingress admission control reads heap / pbuf pool occupancy from lwip_stats.
+ * Only memory statistics are compiled in.
+ */
+#define LWIP_STATS         1
+#define LWIP_STATS_DISPLAY 0
+#define MEM_STATS          1
+#define MEMP_STATS         1
+#define LINK_STATS         0
+#define IP_STATS           0
+#define IPFRAG_STATS       0
+#define ICMP_STATS         0
+#define TCP_STATS          0
+#define SYS_STATS          0
+#define MIB2_STATS         0
 
 /* ================================================================
  * Debug / Logging Configuration (Visibility ONLY)
  * ================================================================ */
 
-#define LWIP_STATS 0
-
 #if TUNFORGE_LWIP_DEBUG_PROFILE == 0
 
 #define LWIP_DEBUG 0
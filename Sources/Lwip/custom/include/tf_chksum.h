@@ -0,0 +1,53 @@
+//
+//  tf_chksum.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+//  Vectorized Internet checksum kernels, wired into lwIP through LWIP_CHKSUM.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	TF_CHKSUM_KERNEL_SCALAR = 0,
+	TF_CHKSUM_KERNEL_NEON = 1,
+	TF_CHKSUM_KERNEL_SSE2 = 2,
+	TF_CHKSUM_KERNEL_AVX2 = 3,
+	TF_CHKSUM_KERNEL_COUNT = 4
+} tf_chksum_kernel_t;
+
+/// LWIP_CHKSUM entry point: same contract as lwip_standard_chksum
+/// (any alignment, host-order non-inverted sum), dispatched to the best kernel.
+uint16_t tf_chksum(const void *dataptr, int len);
+
+/// LWIP_CHKSUM_COPY entry point: copies `len` bytes and returns tf_chksum() of them,
+/// in one pass over the data.
+uint16_t tf_chksum_copy(void *dst, const void *src, uint16_t len);
+
+/// lwIP's scalar algorithm #2; the reference every kernel must match.
+uint16_t lwip_standard_chksum(const void *dataptr, int len);
+
+/// Whether `kernel` is compiled in and supported by the running CPU.
+int tf_chksum_kernel_available(tf_chksum_kernel_t kernel);
+
+/// Runs one specific kernel (falls back to scalar when unavailable).
+uint16_t tf_chksum_kernel(tf_chksum_kernel_t kernel, const void *dataptr, int len);
+
+/// Copy-and-sum variant of tf_chksum_kernel().
+uint16_t tf_chksum_copy_kernel(tf_chksum_kernel_t kernel, void *dst, const void *src, int len);
+
+/// Kernel tf_chksum() dispatches to on this CPU.
+tf_chksum_kernel_t tf_chksum_active_kernel(void);
+
+const char *tf_chksum_kernel_name(tf_chksum_kernel_t kernel);
+
+#ifdef __cplusplus
+}
+#endif
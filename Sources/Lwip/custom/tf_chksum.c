@@ -0,0 +1,413 @@
+//
+//  tf_chksum.c
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#include "tf_chksum.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define TF_CHKSUM_HAVE_NEON 1
+#include <arm_neon.h>
+#elif defined(__x86_64__)
+#define TF_CHKSUM_HAVE_SSE2 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if TF_CHKSUM_HAVE_NEON || TF_CHKSUM_HAVE_SSE2
+
+/*
+ * All kernels below sum the buffer as little-endian u16 words counted from
+ * its first byte (arm64 / x86_64 only). Because 2^16 == 1 (mod 0xffff) that
+ * is the same one's-complement sum lwip_standard_chksum() reaches through its
+ * odd-address byte swap, and both only fold to 0 for an all-zero buffer, so
+ * the 16-bit results are bit-identical.
+ */
+
+/* Vector blocks summed into u32 lanes before widening; each lane takes at
+ * most 4 * 0xffff per block, so 4096 blocks stay far below 2^32. */
+#define TF_CHKSUM_BLOCKS_MAX 4096
+
+/* Below this a vector setup costs more than it saves. */
+#define TF_CHKSUM_VECTOR_MIN 64
+
+/*
+ * Kernel bodies take an optional destination: NULL sums in place, non-NULL
+ * stores every loaded vector as well (LWIP_CHKSUM_COPY), so copy-and-sum is
+ * a single pass. Always inlined so both variants are specialized.
+ */
+#define TF_CHKSUM_INLINE static inline __attribute__((always_inline))
+
+TF_CHKSUM_INLINE uint64_t tf_chksum_tail(uint8_t *dst, const uint8_t *p, int len, uint64_t acc) {
+    while (len >= 8) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        if (dst) {
+            memcpy(dst, &w, sizeof(w));
+            dst += 8;
+        }
+        acc += (w & 0xffffffffULL) + (w >> 32);
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        uint32_t w;
+        memcpy(&w, p, sizeof(w));
+        if (dst) {
+            memcpy(dst, &w, sizeof(w));
+            dst += 4;
+        }
+        acc += w;
+        p += 4;
+        len -= 4;
+    }
+    if (len >= 2) {
+        uint16_t w;
+        memcpy(&w, p, sizeof(w));
+        if (dst) {
+            memcpy(dst, &w, sizeof(w));
+            dst += 2;
+        }
+        acc += w;
+        p += 2;
+        len -= 2;
+    }
+    if (len > 0) {
+        if (dst) {
+            *dst = *p;
+        }
+        acc += *p;
+    }
+    return acc;
+}
+
+TF_CHKSUM_INLINE uint16_t tf_chksum_fold(uint64_t acc) {
+    acc = (acc & 0xffffffffULL) + (acc >> 32);
+    acc = (acc & 0xffffffffULL) + (acc >> 32);
+    acc = (acc & 0xffffU) + (acc >> 16);
+    acc = (acc & 0xffffU) + (acc >> 16);
+    return (uint16_t)acc;
+}
+
+#endif
+
+/* ---- NEON (arm64) ---- */
+
+#if TF_CHKSUM_HAVE_NEON
+
+TF_CHKSUM_INLINE uint16_t tf_chksum_neon_body(uint8_t *dst, const uint8_t *p, int len) {
+    uint64_t acc = 0;
+
+    while (len >= 64) {
+        int blocks = len / 64;
+        if (blocks > TF_CHKSUM_BLOCKS_MAX) {
+            blocks = TF_CHKSUM_BLOCKS_MAX;
+        }
+        len -= blocks * 64;
+
+        uint32x4_t a0 = vdupq_n_u32(0);
+        uint32x4_t a1 = vdupq_n_u32(0);
+        for (int i = 0; i < blocks; i++) {
+            uint8x16_t v0 = vld1q_u8(p);
+            uint8x16_t v1 = vld1q_u8(p + 16);
+            uint8x16_t v2 = vld1q_u8(p + 32);
+            uint8x16_t v3 = vld1q_u8(p + 48);
+            if (dst) {
+                vst1q_u8(dst, v0);
+                vst1q_u8(dst + 16, v1);
+                vst1q_u8(dst + 32, v2);
+                vst1q_u8(dst + 48, v3);
+                dst += 64;
+            }
+            a0 = vpadalq_u16(a0, vreinterpretq_u16_u8(v0));
+            a1 = vpadalq_u16(a1, vreinterpretq_u16_u8(v1));
+            a0 = vpadalq_u16(a0, vreinterpretq_u16_u8(v2));
+            a1 = vpadalq_u16(a1, vreinterpretq_u16_u8(v3));
+            p += 64;
+        }
+        acc += vaddvq_u64(vpadalq_u32(vpaddlq_u32(a0), a1));
+    }
+    return tf_chksum_fold(tf_chksum_tail(dst, p, len, acc));
+}
+
+static uint16_t tf_chksum_neon(const void *dataptr, int len) {
+    return tf_chksum_neon_body(NULL, (const uint8_t *)dataptr, len);
+}
+
+static uint16_t tf_chksum_copy_neon(void *dst, const void *src, int len) {
+    return tf_chksum_neon_body((uint8_t *)dst, (const uint8_t *)src, len);
+}
+
+#endif
+
+/* ---- SSE2 / AVX2 (x86_64) ---- */
+
+#if TF_CHKSUM_HAVE_SSE2
+
+#define TF_CHKSUM_AVX2 __attribute__((target("avx2")))
+
+TF_CHKSUM_INLINE uint64_t tf_chksum_sse2_widen(__m128i a) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i s = _mm_add_epi64(_mm_unpacklo_epi32(a, zero), _mm_unpackhi_epi32(a, zero));
+    return (uint64_t)_mm_cvtsi128_si64(s) + (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(s, s));
+}
+
+TF_CHKSUM_INLINE uint16_t tf_chksum_sse2_body(uint8_t *dst, const uint8_t *p, int len) {
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t acc = 0;
+
+    while (len >= 64) {
+        int blocks = len / 64;
+        if (blocks > TF_CHKSUM_BLOCKS_MAX) {
+            blocks = TF_CHKSUM_BLOCKS_MAX;
+        }
+        len -= blocks * 64;
+
+        __m128i a0 = zero;
+        __m128i a1 = zero;
+        for (int i = 0; i < blocks; i++) {
+            __m128i v0 = _mm_loadu_si128((const __m128i *)(const void *)p);
+            __m128i v1 = _mm_loadu_si128((const __m128i *)(const void *)(p + 16));
+            __m128i v2 = _mm_loadu_si128((const __m128i *)(const void *)(p + 32));
+            __m128i v3 = _mm_loadu_si128((const __m128i *)(const void *)(p + 48));
+            if (dst) {
+                _mm_storeu_si128((__m128i *)(void *)dst, v0);
+                _mm_storeu_si128((__m128i *)(void *)(dst + 16), v1);
+                _mm_storeu_si128((__m128i *)(void *)(dst + 32), v2);
+                _mm_storeu_si128((__m128i *)(void *)(dst + 48), v3);
+                dst += 64;
+            }
+            a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(v0, zero));
+            a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(v0, zero));
+            a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(v1, zero));
+            a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(v1, zero));
+            a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(v2, zero));
+            a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(v2, zero));
+            a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(v3, zero));
+            a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(v3, zero));
+            p += 64;
+        }
+        acc += tf_chksum_sse2_widen(a0) + tf_chksum_sse2_widen(a1);
+    }
+    return tf_chksum_fold(tf_chksum_tail(dst, p, len, acc));
+}
+
+TF_CHKSUM_AVX2 TF_CHKSUM_INLINE uint16_t tf_chksum_avx2_body(uint8_t *dst, const uint8_t *p, int len) {
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t acc = 0;
+
+    while (len >= 128) {
+        int blocks = len / 128;
+        if (blocks > TF_CHKSUM_BLOCKS_MAX) {
+            blocks = TF_CHKSUM_BLOCKS_MAX;
+        }
+        len -= blocks * 128;
+
+        __m256i a0 = zero;
+        __m256i a1 = zero;
+        for (int i = 0; i < blocks; i++) {
+            __m256i v0 = _mm256_loadu_si256((const __m256i *)(const void *)p);
+            __m256i v1 = _mm256_loadu_si256((const __m256i *)(const void *)(p + 32));
+            __m256i v2 = _mm256_loadu_si256((const __m256i *)(const void *)(p + 64));
+            __m256i v3 = _mm256_loadu_si256((const __m256i *)(const void *)(p + 96));
+            if (dst) {
+                _mm256_storeu_si256((__m256i *)(void *)dst, v0);
+                _mm256_storeu_si256((__m256i *)(void *)(dst + 32), v1);
+                _mm256_storeu_si256((__m256i *)(void *)(dst + 64), v2);
+                _mm256_storeu_si256((__m256i *)(void *)(dst + 96), v3);
+                dst += 128;
+            }
+            a0 = _mm256_add_epi32(a0, _mm256_unpacklo_epi16(v0, zero));
+            a1 = _mm256_add_epi32(a1, _mm256_unpackhi_epi16(v0, zero));
+            a0 = _mm256_add_epi32(a0, _mm256_unpacklo_epi16(v1, zero));
+            a1 = _mm256_add_epi32(a1, _mm256_unpackhi_epi16(v1, zero));
+            a0 = _mm256_add_epi32(a0, _mm256_unpacklo_epi16(v2, zero));
+            a1 = _mm256_add_epi32(a1, _mm256_unpackhi_epi16(v2, zero));
+            a0 = _mm256_add_epi32(a0, _mm256_unpacklo_epi16(v3, zero));
+            a1 = _mm256_add_epi32(a1, _mm256_unpackhi_epi16(v3, zero));
+            p += 128;
+        }
+        acc += tf_chksum_sse2_widen(_mm256_castsi256_si128(a0));
+        acc += tf_chksum_sse2_widen(_mm256_extracti128_si256(a0, 1));
+        acc += tf_chksum_sse2_widen(_mm256_castsi256_si128(a1));
+        acc += tf_chksum_sse2_widen(_mm256_extracti128_si256(a1, 1));
+    }
+    return tf_chksum_fold(tf_chksum_tail(dst, p, len, acc));
+}
+
+static uint16_t tf_chksum_sse2(const void *dataptr, int len) {
+    return tf_chksum_sse2_body(NULL, (const uint8_t *)dataptr, len);
+}
+
+static uint16_t tf_chksum_copy_sse2(void *dst, const void *src, int len) {
+    return tf_chksum_sse2_body((uint8_t *)dst, (const uint8_t *)src, len);
+}
+
+TF_CHKSUM_AVX2 static uint16_t tf_chksum_avx2(const void *dataptr, int len) {
+    return tf_chksum_avx2_body(NULL, (const uint8_t *)dataptr, len);
+}
+
+TF_CHKSUM_AVX2 static uint16_t tf_chksum_copy_avx2(void *dst, const void *src, int len) {
+    return tf_chksum_avx2_body((uint8_t *)dst, (const uint8_t *)src, len);
+}
+
+/* AVX2 needs both the CPUID feature bit and OS-enabled YMM state (XCR0). */
+static int tf_chksum_cpu_has_avx2(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+        return 0;
+    }
+    unsigned int xcr0Lo, xcr0Hi;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+    if ((xcr0Lo & 0x6) != 0x6) {
+        return 0;
+    }
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ebx & bit_AVX2) != 0;
+}
+
+/* -1: not probed yet. Probing is idempotent, so racing first callers are harmless. */
+static _Atomic int s_has_avx2 = -1;
+
+static inline int tf_chksum_has_avx2(void) {
+    int has = atomic_load_explicit(&s_has_avx2, memory_order_relaxed);
+    if (has < 0) {
+        has = tf_chksum_cpu_has_avx2();
+        atomic_store_explicit(&s_has_avx2, has, memory_order_relaxed);
+    }
+    return has;
+}
+
+#endif
+
+/* ---- Dispatch ---- */
+
+uint16_t tf_chksum(const void *dataptr, int len) {
+#if TF_CHKSUM_HAVE_NEON
+    if (len < TF_CHKSUM_VECTOR_MIN) {
+        return tf_chksum_fold(tf_chksum_tail(NULL, (const uint8_t *)dataptr, len, 0));
+    }
+    return tf_chksum_neon(dataptr, len);
+#elif TF_CHKSUM_HAVE_SSE2
+    if (len < TF_CHKSUM_VECTOR_MIN) {
+        return tf_chksum_fold(tf_chksum_tail(NULL, (const uint8_t *)dataptr, len, 0));
+    }
+    if (len >= 128 && tf_chksum_has_avx2()) {
+        return tf_chksum_avx2(dataptr, len);
+    }
+    return tf_chksum_sse2(dataptr, len);
+#else
+    return lwip_standard_chksum(dataptr, len);
+#endif
+}
+
+uint16_t tf_chksum_copy(void *dst, const void *src, uint16_t len) {
+#if TF_CHKSUM_HAVE_NEON
+    if (len < TF_CHKSUM_VECTOR_MIN) {
+        return tf_chksum_fold(tf_chksum_tail((uint8_t *)dst, (const uint8_t *)src, len, 0));
+    }
+    return tf_chksum_copy_neon(dst, src, len);
+#elif TF_CHKSUM_HAVE_SSE2
+    if (len < TF_CHKSUM_VECTOR_MIN) {
+        return tf_chksum_fold(tf_chksum_tail((uint8_t *)dst, (const uint8_t *)src, len, 0));
+    }
+    if (len >= 128 && tf_chksum_has_avx2()) {
+        return tf_chksum_copy_avx2(dst, src, len);
+    }
+    return tf_chksum_copy_sse2(dst, src, len);
+#else
+    memcpy(dst, src, len);
+    return lwip_standard_chksum(dst, len);
+#endif
+}
+
+int tf_chksum_kernel_available(tf_chksum_kernel_t kernel) {
+    switch (kernel) {
+    case TF_CHKSUM_KERNEL_SCALAR:
+        return 1;
+#if TF_CHKSUM_HAVE_NEON
+    case TF_CHKSUM_KERNEL_NEON:
+        return 1;
+#endif
+#if TF_CHKSUM_HAVE_SSE2
+    case TF_CHKSUM_KERNEL_SSE2:
+        return 1;
+    case TF_CHKSUM_KERNEL_AVX2:
+        return tf_chksum_has_avx2();
+#endif
+    default:
+        return 0;
+    }
+}
+
+uint16_t tf_chksum_kernel(tf_chksum_kernel_t kernel, const void *dataptr, int len) {
+    if (!tf_chksum_kernel_available(kernel)) {
+        kernel = TF_CHKSUM_KERNEL_SCALAR;
+    }
+    switch (kernel) {
+#if TF_CHKSUM_HAVE_NEON
+    case TF_CHKSUM_KERNEL_NEON:
+        return tf_chksum_neon(dataptr, len);
+#endif
+#if TF_CHKSUM_HAVE_SSE2
+    case TF_CHKSUM_KERNEL_SSE2:
+        return tf_chksum_sse2(dataptr, len);
+    case TF_CHKSUM_KERNEL_AVX2:
+        return tf_chksum_avx2(dataptr, len);
+#endif
+    default:
+        return lwip_standard_chksum(dataptr, len);
+    }
+}
+
+uint16_t tf_chksum_copy_kernel(tf_chksum_kernel_t kernel, void *dst, const void *src, int len) {
+    if (!tf_chksum_kernel_available(kernel)) {
+        kernel = TF_CHKSUM_KERNEL_SCALAR;
+    }
+    switch (kernel) {
+#if TF_CHKSUM_HAVE_NEON
+    case TF_CHKSUM_KERNEL_NEON:
+        return tf_chksum_copy_neon(dst, src, len);
+#endif
+#if TF_CHKSUM_HAVE_SSE2
+    case TF_CHKSUM_KERNEL_SSE2:
+        return tf_chksum_copy_sse2(dst, src, len);
+    case TF_CHKSUM_KERNEL_AVX2:
+        return tf_chksum_copy_avx2(dst, src, len);
+#endif
+    default:
+        memcpy(dst, src, (size_t)len);
+        return lwip_standard_chksum(dst, len);
+    }
+}
+
+tf_chksum_kernel_t tf_chksum_active_kernel(void) {
+#if TF_CHKSUM_HAVE_NEON
+    return TF_CHKSUM_KERNEL_NEON;
+#elif TF_CHKSUM_HAVE_SSE2
+    return tf_chksum_has_avx2() ? TF_CHKSUM_KERNEL_AVX2 : TF_CHKSUM_KERNEL_SSE2;
+#else
+    return TF_CHKSUM_KERNEL_SCALAR;
+#endif
+}
+
+const char *tf_chksum_kernel_name(tf_chksum_kernel_t kernel) {
+    switch (kernel) {
+    case TF_CHKSUM_KERNEL_SCALAR:
+        return "scalar";
+    case TF_CHKSUM_KERNEL_NEON:
+        return "neon";
+    case TF_CHKSUM_KERNEL_SSE2:
+        return "sse2";
+    case TF_CHKSUM_KERNEL_AVX2:
+        return "avx2";
+    default:
+        return "unknown";
+    }
+}
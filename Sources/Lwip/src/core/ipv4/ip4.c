@@ -1037,7 +1037,12 @@ ip4_output_if_opt_src(struct pbuf *p, const ip4_addr_t *src, const ip4_addr_t *d
 #endif /* ENABLE_LOOPBACK */
 #if IP_FRAG
   /* don't fragment if interface has mtu set to 0 [loopif] */
+#if LWIP_TUNFORGE_IP_HOOK && LWIP_TUNFORGE_TCP_HOOK && LWIP_TCP
+  /* TunForge: large-send super-segments are cut by the netif, not fragmented */
+  if (netif->mtu && (p->tot_len > netif->mtu) && tcp_tunforge_gso_mss() == 0) {
+#else
   if (netif->mtu && (p->tot_len > netif->mtu)) {
+#endif
     return ip4_frag(p, netif, dest);
   }
 #endif /* IP_FRAG */
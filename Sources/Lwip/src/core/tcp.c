@@ -212,6 +212,9 @@ tcp_free(struct tcp_pcb *pcb)
   LWIP_ASSERT("tcp_free: LISTEN", pcb->state != LISTEN);
 #if LWIP_TCP_PCB_NUM_EXT_ARGS
   tcp_ext_arg_invoke_callbacks_destroyed(pcb->ext_args);
+#endif
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_rx_unaccount(pcb);
 #endif
   memp_free(MEMP_TCP_PCB, pcb);
 }
@@ -959,6 +962,30 @@ tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb)
   }
 }
 
+#if LWIP_TUNFORGE_TCP_HOOK
+/**
+ * TunForge: lets `len` bytes of credit close a window shrunk below what it
+ * held (see tcp_tunforge_set_rcv_wnd_max) instead of reopening rcv_wnd.
+ *
+ * @return the credit left for rcv_wnd
+ */
+static u32_t
+tcp_tunforge_rcv_wnd_repay(struct tcp_pcb *pcb, u32_t len)
+{
+  tcpwnd_size_t repaid;
+
+  if (pcb->tunforge_rcv_wnd_debt == 0) {
+    return len;
+  }
+  /* only credit for held bytes: a surplus must not close the window under rcv_wnd */
+  repaid = (tcpwnd_size_t)LWIP_MIN(len, pcb->tunforge_rcv_wnd_debt);
+  repaid = LWIP_MIN(repaid, (tcpwnd_size_t)(TCP_WND_MAX(pcb) - pcb->rcv_wnd));
+  pcb->tunforge_rcv_wnd_debt = (tcpwnd_size_t)(pcb->tunforge_rcv_wnd_debt - repaid);
+  pcb->tunforge_rcv_wnd_max = (tcpwnd_size_t)(pcb->tunforge_rcv_wnd_max - repaid);
+  return len - repaid;
+}
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
 /**
  * @ingroup tcp_raw
  * This function should be called by the application when it has
@@ -982,6 +1009,9 @@ tcp_recved(struct tcp_pcb *pcb, u16_t len)
   LWIP_ASSERT("don't call tcp_recved for listen-pcbs",
               pcb->state != LISTEN);
 
+#if LWIP_TUNFORGE_TCP_HOOK
+  len = (u16_t)tcp_tunforge_rcv_wnd_repay(pcb, len);
+#endif
   rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd + len);
   if ((rcv_wnd > TCP_WND_MAX(pcb)) || (rcv_wnd < pcb->rcv_wnd)) {
     /* window got too big or tcpwnd_size_t overflow */
@@ -990,6 +1020,9 @@ tcp_recved(struct tcp_pcb *pcb, u16_t len)
   } else  {
     pcb->rcv_wnd = rcv_wnd;
   }
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_rx_account(pcb);
+#endif
 
   wnd_inflation = tcp_update_rcv_ann_wnd(pcb);
 
@@ -999,7 +1032,12 @@ tcp_recved(struct tcp_pcb *pcb, u16_t len)
    * events (or more window to be available later) */
   if (wnd_inflation >= TCP_WND_UPDATE_THRESHOLD) {
     tcp_ack_now(pcb);
-    tcp_output(pcb);
+#if LWIP_TUNFORGE_TCP_HOOK
+    if (!tcp_tunforge_defer_output(pcb))
+#endif
+    {
+      tcp_output(pcb);
+    }
   }
 
   LWIP_DEBUGF(TCP_DEBUG, ("tcp_recved: received %"U16_F" bytes, wnd %"TCPWNDSIZE_F" (%"TCPWNDSIZE_F").\n",
@@ -1538,6 +1576,412 @@ tcp_txnow(void)
   }
 }
 
+#if LWIP_TUNFORGE_TCP_HOOK
+/** TunForge: nesting depth of the current input batch (0: not batching) */
+static u8_t tcp_tunforge_batch_depth;
+/** TunForge: stretch-ACK policy, see tcp_tunforge_set_ack_policy() (0 segs: lwIP's) */
+static u16_t tcp_tunforge_ack_every_segs;
+static u32_t tcp_tunforge_ack_every_bytes;
+
+/**
+ * TunForge: open an input batch. Until the matching tcp_tunforge_batch_end(),
+ * the ACK / window update tcp_output() calls issued by tcp_input() and
+ * tcp_recved() are postponed and flushed once per pcb at batch end.
+ */
+void
+tcp_tunforge_batch_begin(void)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ASSERT("tcp_tunforge_batch_begin: nesting overflow", tcp_tunforge_batch_depth < 0xff);
+  tcp_tunforge_batch_depth++;
+}
+
+static void
+tcp_tunforge_flush_deferred(struct tcp_pcb *list)
+{
+  struct tcp_pcb *pcb;
+
+  for (pcb = list; pcb != NULL; pcb = pcb->next) {
+    if (pcb->flags & TF_TUNFORGE_OUTPUT_DEFERRED) {
+      tcp_clear_flags(pcb, TF_TUNFORGE_OUTPUT_DEFERRED);
+      if ((tcp_tunforge_ack_every_segs != 0) && (pcb->flags & TF_ACK_DELAY)) {
+        /* stretched ACKs never outlive the batch */
+        tcp_ack_now(pcb);
+      }
+      tcp_output(pcb);
+    }
+  }
+}
+
+/** TunForge: close an input batch; the outermost close flushes deferred output. */
+void
+tcp_tunforge_batch_end(void)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ASSERT("tcp_tunforge_batch_end: no open batch", tcp_tunforge_batch_depth > 0);
+  if (--tcp_tunforge_batch_depth > 0) {
+    return;
+  }
+  /* tcp_output() never moves or frees pcbs, so plain list walks are safe.
+     TIME_WAIT pcbs may still owe the ACK for the peer's FIN. */
+  tcp_tunforge_flush_deferred(tcp_active_pcbs);
+  tcp_tunforge_flush_deferred(tcp_tw_pcbs);
+}
+
+/**
+ * TunForge: returns 1 if tcp_output() for this pcb must wait for the end of
+ * the current input batch (the pcb is marked and flushed there), 0 otherwise.
+ */
+u8_t
+tcp_tunforge_defer_output(struct tcp_pcb *pcb)
+{
+  if (tcp_tunforge_batch_depth == 0) {
+    return 0;
+  }
+  tcp_set_flags(pcb, TF_TUNFORGE_OUTPUT_DEFERRED);
+  return 1;
+}
+
+/**
+ * TunForge: stretch-ACK policy for the local TUN peer. Within an input batch,
+ * in-order data is acknowledged once every `segs` MSS-sized segments or `bytes`
+ * bytes instead of every second segment, and whatever is still unacknowledged
+ * at batch end is acknowledged then. Outside a batch lwIP's delayed ACK applies.
+ *
+ * @param segs segments per ACK, 0 restores lwIP's delayed ACK
+ * @param bytes bytes per ACK, 0 for no byte bound
+ */
+void
+tcp_tunforge_set_ack_policy(u16_t segs, u32_t bytes)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+  tcp_tunforge_ack_every_segs = segs;
+  tcp_tunforge_ack_every_bytes = bytes;
+}
+
+/**
+ * TunForge: tcp_ack() replacement for in-order data, applying the stretch-ACK
+ * policy. ACKs immediately on PSH / FIN (`urgent`), once the policy's segment
+ * or byte count is reached, or once the peer has used half of the window it
+ * was last promised.
+ *
+ * @param len bytes rcv_nxt advanced by
+ */
+void
+tcp_tunforge_ack(struct tcp_pcb *pcb, u32_t len, u8_t urgent)
+{
+  u32_t promised, segs;
+
+  if ((tcp_tunforge_ack_every_segs == 0) || (tcp_tunforge_batch_depth == 0)) {
+    tcp_ack(pcb);
+    return;
+  }
+  if (!(pcb->flags & (TF_ACK_DELAY | TF_ACK_NOW))) {
+    /* an ACK went out since the last call: start counting afresh */
+    pcb->tunforge_ack_segs = 0;
+    pcb->tunforge_ack_bytes = 0;
+  }
+  segs = pcb->tunforge_ack_segs + (len + pcb->mss - 1) / pcb->mss;
+  pcb->tunforge_ack_segs = (u16_t)LWIP_MIN(segs, 0xffff);
+  pcb->tunforge_ack_bytes += len;
+
+  promised = TCP_SEQ_GT(pcb->rcv_ann_right_edge, pcb->rcv_nxt) ?
+             pcb->rcv_ann_right_edge - pcb->rcv_nxt : 0;
+  if (urgent ||
+      (pcb->tunforge_ack_segs >= tcp_tunforge_ack_every_segs) ||
+      ((tcp_tunforge_ack_every_bytes != 0) &&
+       (pcb->tunforge_ack_bytes >= tcp_tunforge_ack_every_bytes)) ||
+      (promised < pcb->tunforge_ack_bytes)) {
+    tcp_ack_now(pcb);
+  } else {
+    tcp_set_flags(pcb, TF_ACK_DELAY);
+  }
+}
+
+/**
+ * TunForge: hand refused_data back to the recv callback now, rather than on
+ * the next tcp_fasttmr() (up to TCP_TMR_INTERVAL later). Call once the
+ * application can take data again. Not from within tcp_input() for this pcb.
+ *
+ * @return ERR_ABRT if the pcb was aborted (do not touch it any more),
+ *         ERR_INPROGRESS if the data was refused again, ERR_OK otherwise
+ */
+err_t
+tcp_tunforge_process_refused(struct tcp_pcb *pcb)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("tcp_tunforge_process_refused: invalid pcb", pcb != NULL, return ERR_ARG);
+  if ((pcb->refused_data == NULL) || (tcp_input_pcb == pcb)) {
+    return ERR_OK;
+  }
+  return tcp_process_refused_data(pcb);
+}
+
+/**
+ * TunForge: tcp_recved() for credit coalesced over a turn. Takes any length,
+ * opens the window in one step and makes one window-update decision against
+ * `threshold` instead of TCP_WND_UPDATE_THRESHOLD.
+ *
+ * @param threshold minimum right-edge advance worth a window-update ACK;
+ *        0 for TCP_WND_UPDATE_THRESHOLD. Capped at half the window so a
+ *        drained receiver always announces itself.
+ */
+void
+tcp_tunforge_recved(struct tcp_pcb *pcb, u32_t len, u32_t threshold)
+{
+  u32_t wnd_max, rcv_wnd, wnd_inflation;
+
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("tcp_tunforge_recved: invalid pcb", pcb != NULL, return);
+  LWIP_ASSERT("don't call tcp_tunforge_recved for listen-pcbs", pcb->state != LISTEN);
+
+  len = tcp_tunforge_rcv_wnd_repay(pcb, len);
+  wnd_max = TCP_WND_MAX(pcb);
+  rcv_wnd = (u32_t)pcb->rcv_wnd + LWIP_MIN(len, wnd_max);
+  pcb->rcv_wnd = (tcpwnd_size_t)LWIP_MIN(rcv_wnd, wnd_max);
+  tcp_tunforge_rx_account(pcb);
+
+  wnd_inflation = tcp_update_rcv_ann_wnd(pcb);
+
+  if (threshold == 0) {
+    threshold = TCP_WND_UPDATE_THRESHOLD;
+  }
+  threshold = LWIP_MIN(threshold, wnd_max / 2);
+  if ((wnd_inflation > 0) && (wnd_inflation >= threshold)) {
+    tcp_ack_now(pcb);
+    if (!tcp_tunforge_defer_output(pcb)) {
+      tcp_output(pcb);
+    }
+  }
+}
+
+/**
+ * TunForge: resizes the receive window of a connected pcb (window autotuning).
+ *
+ * rcv_wnd + held == window size holds before and after, so unconsumed data
+ * keeps its accounting. Growing announces the new space right away; shrinking
+ * never retracts an already announced right edge. What the window cannot give
+ * up yet is recorded as debt: later tcp_recved() credit closes the window by
+ * that much before rcv_wnd reopens, so it reaches `wnd_max` as the peer fills
+ * what it was promised.
+ *
+ * @param wnd_max requested window size, clamped to what the negotiated scale
+ *        can announce; 0 restores TCP_WND
+ * @return the window size actually applied
+ */
+tcpwnd_size_t
+tcp_tunforge_set_rcv_wnd_max(struct tcp_pcb *pcb, tcpwnd_size_t wnd_max)
+{
+  tcpwnd_size_t cur_max, held, promised, floor, goal;
+
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("tcp_tunforge_set_rcv_wnd_max: invalid pcb", pcb != NULL, return 0);
+  LWIP_ASSERT("don't call tcp_tunforge_set_rcv_wnd_max for listen-pcbs", pcb->state != LISTEN);
+
+  cur_max = TCP_WND_MAX(pcb);
+  if (wnd_max == 0) {
+    wnd_max = TCP_WND_DEFAULT(pcb);
+  }
+  wnd_max = LWIP_MIN(wnd_max, TCP_WND_CEIL(pcb));
+  held = (tcpwnd_size_t)(cur_max - pcb->rcv_wnd);
+
+  pcb->tunforge_rcv_wnd_debt = 0;
+  if (wnd_max > cur_max) {
+    pcb->tunforge_rcv_wnd_max = wnd_max;
+    pcb->rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd + (wnd_max - cur_max));
+    tcp_recved(pcb, 0);
+  } else if (wnd_max < cur_max) {
+    /* keep room for everything held plus what the peer was already promised */
+    promised = TCP_SEQ_GT(pcb->rcv_ann_right_edge, pcb->rcv_nxt) ?
+               (tcpwnd_size_t)(pcb->rcv_ann_right_edge - pcb->rcv_nxt) : 0;
+    floor = (tcpwnd_size_t)(held + promised);
+    goal = wnd_max;
+    wnd_max = LWIP_MAX(wnd_max, LWIP_MIN(floor, cur_max));
+    pcb->tunforge_rcv_wnd_debt = (tcpwnd_size_t)(wnd_max - goal);
+    pcb->tunforge_rcv_wnd_max = wnd_max;
+    pcb->rcv_wnd = (tcpwnd_size_t)(wnd_max - held);
+    tcp_update_rcv_ann_wnd(pcb);
+  }
+  return wnd_max;
+}
+
+/**
+ * TunForge: resizes the send buffer of a pcb (send-buffer autotuning).
+ *
+ * snd_buf - debt + queued == buffer size holds before and after. Shrinking below
+ * what is already queued records the difference as debt that later ACKs repay
+ * before snd_buf grows again; nothing queued is dropped.
+ *
+ * TCP_SND_BUF stays the ceiling: TCP_SND_QUEUELEN and the segment pool are
+ * sized for it.
+ *
+ * @param buf_max requested buffer size, 0 restores TCP_SND_BUF
+ * @return the buffer size actually applied
+ */
+tcpwnd_size_t
+tcp_tunforge_set_snd_buf_max(struct tcp_pcb *pcb, tcpwnd_size_t buf_max)
+{
+  tcpwnd_size_t cur_max, delta, taken;
+
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("tcp_tunforge_set_snd_buf_max: invalid pcb", pcb != NULL, return 0);
+
+  cur_max = pcb->tunforge_snd_buf_max ? pcb->tunforge_snd_buf_max : TCP_SND_BUF;
+  if ((buf_max == 0) || (buf_max > TCP_SND_BUF)) {
+    buf_max = TCP_SND_BUF;
+  }
+
+  if (buf_max > cur_max) {
+    delta = (tcpwnd_size_t)(buf_max - cur_max);
+    taken = LWIP_MIN(delta, pcb->tunforge_snd_buf_debt);
+    pcb->tunforge_snd_buf_debt = (tcpwnd_size_t)(pcb->tunforge_snd_buf_debt - taken);
+    pcb->snd_buf = (tcpwnd_size_t)(pcb->snd_buf + (delta - taken));
+  } else if (buf_max < cur_max) {
+    delta = (tcpwnd_size_t)(cur_max - buf_max);
+    taken = LWIP_MIN(delta, pcb->snd_buf);
+    pcb->snd_buf = (tcpwnd_size_t)(pcb->snd_buf - taken);
+    pcb->tunforge_snd_buf_debt = (tcpwnd_size_t)(pcb->tunforge_snd_buf_debt + (delta - taken));
+  }
+  pcb->tunforge_snd_buf_max = buf_max;
+  return buf_max;
+}
+
+/** TunForge: active pcbs holding receive-side bytes (tunforge_rx_holding set) */
+static u16_t tcp_tunforge_rx_flows;
+
+/** TunForge: receive-side bytes a pcb holds (unconsumed in-order data + ooseq) */
+static u32_t
+tcp_tunforge_pcb_rx_held(const struct tcp_pcb *pcb)
+{
+  return (u32_t)(TCP_WND_MAX(pcb) - pcb->rcv_wnd) + pcb->tunforge_ooseq_bytes;
+}
+
+/**
+ * TunForge: refreshes the receive-side accounting of a pcb after its rcv_wnd
+ * or ooseq queue changed (tcp_receive, tcp_recved, tcp_free_ooseq). Only this
+ * pcb's ooseq queue is walked, and only while it has one.
+ */
+void
+tcp_tunforge_rx_account(struct tcp_pcb *pcb)
+{
+  u8_t holding;
+
+#if TCP_QUEUE_OOSEQ
+  if ((pcb->ooseq != NULL) || (pcb->tunforge_ooseq_bytes != 0)) {
+    const struct tcp_seg *seg;
+    u32_t bytes = 0;
+
+    for (seg = pcb->ooseq; seg != NULL; seg = seg->next) {
+      bytes += seg->p->tot_len;
+    }
+    pcb->tunforge_ooseq_bytes = bytes;
+  }
+#endif /* TCP_QUEUE_OOSEQ */
+
+  holding = tcp_tunforge_pcb_rx_held(pcb) > 0;
+  if (holding != pcb->tunforge_rx_holding) {
+    pcb->tunforge_rx_holding = holding;
+    if (holding) {
+      tcp_tunforge_rx_flows++;
+    } else {
+      tcp_tunforge_rx_flows--;
+    }
+  }
+}
+
+/** TunForge: drops a pcb from the receive-side accounting (purged or freed) */
+void
+tcp_tunforge_rx_unaccount(struct tcp_pcb *pcb)
+{
+  pcb->tunforge_ooseq_bytes = 0;
+  if (pcb->tunforge_rx_holding) {
+    pcb->tunforge_rx_holding = 0;
+    tcp_tunforge_rx_flows--;
+  }
+}
+
+/**
+ * TunForge: admission control helper. Looks up the active pcb an inbound
+ * segment (src -> dst) belongs to and returns the receive-side bytes it holds.
+ * Held bytes and the flow count are kept up to date as they change, so this is
+ * a plain lookup; tcp_input() moves busy pcbs to the front of the list.
+ *
+ * @param flows set to the number of active pcbs holding any receive-side bytes
+ * @return held bytes of the matching pcb, 0 if there is none
+ */
+u32_t
+tcp_tunforge_rx_held(const ip_addr_t *src, u16_t sport, const ip_addr_t *dst, u16_t dport,
+                     u16_t *flows)
+{
+  struct tcp_pcb *pcb;
+  u32_t match = 0;
+
+  LWIP_ASSERT_CORE_LOCKED();
+  for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+    if (pcb->remote_port == sport && pcb->local_port == dport &&
+        ip_addr_eq(&pcb->remote_ip, src) && ip_addr_eq(&pcb->local_ip, dst)) {
+      match = tcp_tunforge_pcb_rx_held(pcb);
+      break;
+    }
+  }
+  if (flows != NULL) {
+    *flows = tcp_tunforge_rx_flows;
+  }
+  return match;
+}
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
+#if LWIP_TUNFORGE_TCP_HOOK && LWIP_SUPPORT_CUSTOM_PBUF
+/**
+ * TunForge: ingress may wrap caller-owned packet buffers in custom PBUF_REF
+ * pbufs. Data that lwIP parks (->ooseq, ->refused_data) is moved into the
+ * pbuf pool so the caller's buffer is not pinned for an unbounded time.
+ *
+ * @param p the (possibly chained) pbuf to move
+ * @param hdr optional header bytes to place directly in front of the copied payload
+ * @param hdrlen length of hdr (0 if none)
+ * @return a PBUF_POOL copy, or NULL if p references no custom pbuf or the pool is exhausted
+ */
+struct pbuf *
+tcp_tunforge_pbuf_unref(struct pbuf *p, const void *hdr, u16_t hdrlen)
+{
+  struct pbuf *q, *r;
+  u16_t offset;
+
+  for (r = p; r != NULL; r = r->next) {
+    if (r->flags & PBUF_FLAG_IS_CUSTOM) {
+      break;
+    }
+  }
+  if (r == NULL) {
+    return NULL;
+  }
+  if ((u32_t)p->tot_len + hdrlen > 0xFFFFU) {
+    return NULL;
+  }
+
+  q = pbuf_alloc(PBUF_RAW, (u16_t)(p->tot_len + hdrlen), PBUF_POOL);
+  if (q == NULL) {
+    return NULL;
+  }
+  /* the first pool pbuf always holds a full TCP header */
+  LWIP_ASSERT("tcp_tunforge_pbuf_unref: header split", q->len >= hdrlen);
+  if (hdrlen > 0) {
+    pbuf_take_at(q, hdr, hdrlen, 0);
+  }
+  offset = hdrlen;
+  for (r = p; r != NULL; r = r->next) {
+    pbuf_take_at(q, r->payload, r->len, offset);
+    offset = (u16_t)(offset + r->len);
+  }
+  if (hdrlen > 0) {
+    pbuf_remove_header(q, hdrlen);
+  }
+  q->flags |= (u8_t)(p->flags & (PBUF_FLAG_PUSH | PBUF_FLAG_TCP_FIN));
+  return q;
+}
+#endif /* LWIP_TUNFORGE_TCP_HOOK && LWIP_SUPPORT_CUSTOM_PBUF */
+
 /** Pass pcb->refused_data to the recv callback */
 err_t
 tcp_process_refused_data(struct tcp_pcb *pcb)
@@ -1674,6 +2118,21 @@ tcp_seg_copy(struct tcp_seg *seg)
     return NULL;
   }
   SMEMCPY((u8_t *)cseg, (const u8_t *)seg, sizeof(struct tcp_seg));
+#if LWIP_TUNFORGE_TCP_HOOK && LWIP_SUPPORT_CUSTOM_PBUF
+  {
+    /* TunForge: don't park caller-owned ingress buffers on ->ooseq */
+    u16_t hdrlen = TCPH_HDRLEN_BYTES(seg->tcphdr);
+    struct pbuf *q = NULL;
+    if ((const u8_t *)seg->tcphdr + hdrlen == (const u8_t *)seg->p->payload) {
+      q = tcp_tunforge_pbuf_unref(seg->p, seg->tcphdr, hdrlen);
+    }
+    if (q != NULL) {
+      cseg->p = q;
+      cseg->tcphdr = (struct tcp_hdr *)((u8_t *)q->payload - hdrlen);
+      return cseg;
+    }
+  }
+#endif /* LWIP_TUNFORGE_TCP_HOOK && LWIP_SUPPORT_CUSTOM_PBUF */
   pbuf_ref(cseg->p);
   return cseg;
 }
@@ -2138,6 +2597,9 @@ tcp_pcb_purge(struct tcp_pcb *pcb)
 {
   LWIP_ERROR("tcp_pcb_purge: invalid pcb", pcb != NULL, return);
 
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_rx_unaccount(pcb);
+#endif
   if (pcb->state != CLOSED &&
       pcb->state != TIME_WAIT &&
       pcb->state != LISTEN) {
@@ -2401,6 +2863,9 @@ tcp_free_ooseq(struct tcp_pcb *pcb)
 #if LWIP_TCP_SACK_OUT
     memset(pcb->rcv_sacks, 0, sizeof(pcb->rcv_sacks));
 #endif /* LWIP_TCP_SACK_OUT */
+#if LWIP_TUNFORGE_TCP_HOOK
+    tcp_tunforge_rx_account(pcb);
+#endif
   }
 }
 #endif /* TCP_QUEUE_OOSEQ */
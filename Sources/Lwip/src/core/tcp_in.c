@@ -531,6 +531,16 @@ tcp_input(struct pbuf *p, struct netif *inp)
               pbuf_cat(recv_data, rest);
             }
 #endif /* TCP_QUEUE_OOSEQ && LWIP_WND_SCALE */
+#if LWIP_TUNFORGE_TCP_HOOK && LWIP_SUPPORT_CUSTOM_PBUF
+            {
+              /* TunForge: don't park caller-owned ingress buffers as refused data */
+              struct pbuf *q = tcp_tunforge_pbuf_unref(recv_data, NULL, 0);
+              if (q != NULL) {
+                pbuf_free(recv_data);
+                recv_data = q;
+              }
+            }
+#endif /* LWIP_TUNFORGE_TCP_HOOK && LWIP_SUPPORT_CUSTOM_PBUF */
             pcb->refused_data = recv_data;
             LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: keep incoming packet, because pcb is \"full\"\n"));
 #if TCP_QUEUE_OOSEQ && LWIP_WND_SCALE
@@ -566,7 +576,12 @@ tcp_input(struct pbuf *p, struct netif *inp)
           goto aborted;
         }
         /* Try to send something out. */
-        tcp_output(pcb);
+#if LWIP_TUNFORGE_TCP_HOOK
+        if (!tcp_tunforge_defer_output(pcb))
+#endif
+        {
+          tcp_output(pcb);
+        }
 #if TCP_INPUT_DEBUG
 #if TCP_DEBUG
         tcp_debug_print_state(pcb->state);
@@ -1340,7 +1355,17 @@ tcp_receive(struct tcp_pcb *pcb)
       }
 #endif /* LWIP_IPV6 && LWIP_ND6_TCP_REACHABILITY_HINTS*/
 
-      pcb->snd_buf = (tcpwnd_size_t)(pcb->snd_buf + recv_acked);
+#if LWIP_TUNFORGE_TCP_HOOK
+      if (pcb->tunforge_snd_buf_debt > 0) {
+        /* the send buffer was shrunk below what was queued: pay that back first */
+        tcpwnd_size_t repaid = LWIP_MIN(pcb->tunforge_snd_buf_debt, recv_acked);
+        pcb->tunforge_snd_buf_debt = (tcpwnd_size_t)(pcb->tunforge_snd_buf_debt - repaid);
+        pcb->snd_buf = (tcpwnd_size_t)(pcb->snd_buf + (recv_acked - repaid));
+      } else
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+      {
+        pcb->snd_buf = (tcpwnd_size_t)(pcb->snd_buf + recv_acked);
+      }
       /* check if this ACK ends our retransmission of in-flight data */
       if (pcb->flags & TF_RTO) {
         /* RTO is done if
@@ -1649,7 +1674,12 @@ tcp_receive(struct tcp_pcb *pcb)
 
 
         /* Acknowledge the segment(s). */
+#if LWIP_TUNFORGE_TCP_HOOK
+        tcp_tunforge_ack(pcb, pcb->rcv_nxt - seqno,
+                         (flags & TCP_PSH) || (recv_flags & TF_GOT_FIN));
+#else
         tcp_ack(pcb);
+#endif
 
 #if LWIP_TCP_SACK_OUT
         if (LWIP_TCP_SACK_VALID(pcb, 0)) {
@@ -1919,6 +1949,9 @@ tcp_receive(struct tcp_pcb *pcb)
       tcp_ack_now(pcb);
     }
   }
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_rx_account(pcb);
+#endif
 }
 
 static u8_t
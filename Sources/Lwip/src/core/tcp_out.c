@@ -130,6 +130,129 @@ static err_t tcp_output_control_segment_netif(const struct tcp_pcb *pcb, struct
                                               const ip_addr_t *src, const ip_addr_t *dst,
                                               struct netif *netif);
 
+#if LWIP_TUNFORGE_TCP_HOOK
+/** TunForge: wire MSS of the GSO super-segment being output (0: regular segment) */
+static u16_t tcp_tunforge_gso_tx_mss;
+
+/**
+ * TunForge: enable or disable large-send for a pcb. tcp_write() then builds
+ * segments of up to TUNFORGE_TCP_GSO_MAX_SEGMENT bytes; the netif output
+ * function cuts them into pcb->mss sized packets (see tcp_tunforge_gso_mss()).
+ * Congestion control, RTO and Nagle keep working in units of pcb->mss.
+ */
+void
+tcp_tunforge_set_gso(struct tcp_pcb *pcb, u8_t enable)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("tcp_tunforge_set_gso: invalid pcb", pcb != NULL, return);
+  if (enable) {
+    tcp_set_flags(pcb, TF_TUNFORGE_GSO);
+  } else {
+    tcp_clear_flags(pcb, TF_TUNFORGE_GSO);
+  }
+}
+
+/**
+ * TunForge: cork or uncork a pcb. While corked, tcp_output() sends full-sized
+ * segments but holds back a trailing segment shorter than pcb->mss, so small
+ * writes coalesce. A queued FIN or an earlier memory error overrides the cork,
+ * as for Nagle. Uncorking does not output; call tcp_output() afterwards.
+ */
+void
+tcp_tunforge_set_cork(struct tcp_pcb *pcb, u8_t enable)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("tcp_tunforge_set_cork: invalid pcb", pcb != NULL, return);
+  if (enable) {
+    tcp_set_flags(pcb, TF_TUNFORGE_CORK);
+  } else {
+    tcp_clear_flags(pcb, TF_TUNFORGE_CORK);
+  }
+}
+
+/**
+ * TunForge: called from the netif output function. Returns the wire MSS the
+ * packet being output must be segmented to, or 0 if it is a regular packet.
+ * A super-segment carries no TCP checksum; the netif computes it per packet.
+ */
+u16_t
+tcp_tunforge_gso_mss(void)
+{
+  return tcp_tunforge_gso_tx_mss;
+}
+
+static u16_t
+tcp_tunforge_gso_segment_mss(const struct tcp_seg *seg, const struct tcp_pcb *pcb)
+{
+  u16_t optlen = LWIP_TCP_OPT_LENGTH_SEGMENT(seg->flags, pcb);
+
+  if (!(pcb->flags & TF_TUNFORGE_GSO) || pcb->mss <= optlen || seg->len <= pcb->mss - optlen) {
+    return 0;
+  }
+  return pcb->mss;
+}
+
+/**
+ * TunForge: segment size tcp_write() builds for a large-send pcb: whole
+ * packets' worth of data, bounded by what cwnd and the peer window take in
+ * one go, and never below the last unsent segment (tcp_write appends to it).
+ */
+static u16_t
+tcp_tunforge_gso_seg_size(const struct tcp_pcb *pcb, u16_t mss_local)
+{
+  const struct tcp_seg *last;
+  u16_t optlen = LWIP_TCP_OPT_LENGTH_SEGMENT(0, pcb);
+  u32_t unit, size;
+
+  if (!(pcb->flags & TF_TUNFORGE_GSO) || pcb->mss <= optlen) {
+    return mss_local;
+  }
+
+  unit = (u32_t)(pcb->mss - optlen);
+  size = LWIP_MIN((u32_t)TUNFORGE_TCP_GSO_MAX_SEGMENT, (u32_t)(pcb->snd_wnd_max / 2));
+  size = LWIP_MIN(size, (u32_t)pcb->cwnd);
+  size = (size / unit) * unit + optlen;
+
+  if (pcb->unsent != NULL) {
+    for (last = pcb->unsent; last->next != NULL; last = last->next);
+    size = LWIP_MAX(size, (u32_t)last->len + LWIP_TCP_OPT_LENGTH_SEGMENT(last->flags, pcb));
+  }
+  return (u16_t)LWIP_MAX(size, mss_local);
+}
+
+/**
+ * TunForge: trim the unsent head of a large-send pcb to whole packets that fit
+ * the window, instead of waiting until the whole super-segment fits.
+ */
+static void
+tcp_tunforge_gso_fit(struct tcp_pcb *pcb, u32_t wnd)
+{
+  struct tcp_seg *seg = pcb->unsent;
+  u16_t optlen, unit;
+  u32_t inflight, avail;
+
+  if (!(pcb->flags & TF_TUNFORGE_GSO) || seg == NULL) {
+    return;
+  }
+  optlen = LWIP_TCP_OPT_LENGTH_SEGMENT(seg->flags, pcb);
+  if (pcb->mss <= optlen || seg->len <= pcb->mss - optlen) {
+    return;
+  }
+
+  inflight = lwip_ntohl(seg->tcphdr->seqno) - pcb->lastack;
+  if (inflight >= wnd || inflight + seg->len <= wnd) {
+    return;
+  }
+  unit = (u16_t)(pcb->mss - optlen);
+  avail = ((wnd - inflight) / unit) * unit;
+  if (avail == 0) {
+    /* less than one packet: regular window handling (persist / wait for ACKs) */
+    return;
+  }
+  tcp_split_unsent_seg(pcb, (u16_t)avail);
+}
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
 /* tcp_route: common code that returns a fixed bound netif or calls ip_route */
 static struct netif *
 tcp_route(const struct tcp_pcb *pcb, const ip_addr_t *src, const ip_addr_t *dst)
@@ -296,6 +419,53 @@ tcp_seg_add_chksum(u16_t chksum, u16_t len, u16_t *seg_chksum,
   }
   *seg_chksum = chksum;
 }
+
+#if LWIP_TUNFORGE_TCP_HOOK
+/* TunForge: pbuf_copy_partial() that sums the copied bytes in the same pass */
+static u16_t
+tcp_tunforge_copy_partial_chksum(const struct pbuf *p, u8_t *dst, u16_t len, u16_t offset,
+                                 u16_t *chksum, u8_t *chksum_swapped)
+{
+  u16_t copied = 0;
+  u16_t n;
+
+  for (; p != NULL && len > 0; p = p->next) {
+    if (offset >= p->len) {
+      offset = (u16_t)(offset - p->len);
+      continue;
+    }
+    n = (u16_t)LWIP_MIN(len, p->len - offset);
+    TCP_DATA_COPY2(dst + copied, (const u8_t *)p->payload + offset, n, chksum, chksum_swapped);
+    copied = (u16_t)(copied + n);
+    len = (u16_t)(len - n);
+    offset = 0;
+  }
+  return copied;
+}
+
+/* TunForge: after tcp_split_unsent_seg() cut `useg` at `split`, derive its data
+ * checksum from the original one minus the remainder's share instead of
+ * re-reading the head. Keeps the (chksum, chksum_swapped) encoding of
+ * tcp_seg_add_chksum(): the sum is stored byte-swapped when the length is odd. */
+static void
+tcp_tunforge_chksum_trim(struct tcp_seg *useg, u16_t split, u16_t rem_chksum, u8_t rem_swapped)
+{
+  u16_t full = useg->chksum_swapped ? SWAP_BYTES_IN_WORD(useg->chksum) : useg->chksum;
+  u16_t rem = rem_swapped ? SWAP_BYTES_IN_WORD(rem_chksum) : rem_chksum;
+  u16_t head;
+  u32_t acc;
+
+  /* the remainder started at offset `split` of the original data */
+  if (split & 1) {
+    rem = SWAP_BYTES_IN_WORD(rem);
+  }
+  acc = (u32_t)full + (u16_t)~rem;
+  head = (u16_t)FOLD_U32T(acc);
+
+  useg->chksum = (split & 1) ? SWAP_BYTES_IN_WORD(head) : head;
+  useg->chksum_swapped = (u8_t)(split & 1);
+}
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
 #endif /* TCP_CHECKSUM_ON_COPY */
 
 /** Checks if tcp_write is allowed or not (checks state, snd_buf and snd_queuelen).
@@ -419,6 +589,9 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
   /* don't allocate segments bigger than half the maximum window we ever received */
   mss_local = LWIP_MIN(pcb->mss, TCPWND_MIN16(pcb->snd_wnd_max / 2));
   mss_local = mss_local ? mss_local : pcb->mss;
+#if LWIP_TUNFORGE_TCP_HOOK
+  mss_local = tcp_tunforge_gso_seg_size(pcb, mss_local);
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
 
   LWIP_ASSERT_CORE_LOCKED();
 
@@ -837,6 +1010,7 @@ tcp_split_unsent_seg(struct tcp_pcb *pcb, u16_t split)
   u8_t remainder_flags;
   u16_t remainder;
   u16_t offset;
+  u16_t copied;
 #if TCP_CHECKSUM_ON_COPY
   u16_t chksum = 0;
   u8_t chksum_swapped = 0;
@@ -859,7 +1033,11 @@ tcp_split_unsent_seg(struct tcp_pcb *pcb, u16_t split)
     return ERR_OK;
   }
 
+#if LWIP_TUNFORGE_TCP_HOOK
+  LWIP_ASSERT("split <= mss", split <= pcb->mss || (pcb->flags & TF_TUNFORGE_GSO));
+#else
   LWIP_ASSERT("split <= mss", split <= pcb->mss);
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
   LWIP_ASSERT("useg->len > 0", useg->len > 0);
 
   /* We should check that we don't exceed TCP_SND_QUEUELEN but we need
@@ -887,16 +1065,23 @@ tcp_split_unsent_seg(struct tcp_pcb *pcb, u16_t split)
   /* Offset into the original pbuf is past TCP/IP headers, options, and split amount */
   offset = useg->p->tot_len - useg->len + split;
   /* Copy remainder into new pbuf, headers and options will not be filled out */
-  if (pbuf_copy_partial(useg->p, (u8_t *)p->payload + optlen, remainder, offset ) != remainder) {
+#if LWIP_TUNFORGE_TCP_HOOK && TCP_CHECKSUM_ON_COPY
+  /* TunForge: copy and checksum the remainder in one pass */
+  copied = tcp_tunforge_copy_partial_chksum(useg->p, (u8_t *)p->payload + optlen, remainder, offset,
+                                            &chksum, &chksum_swapped);
+#else
+  copied = pbuf_copy_partial(useg->p, (u8_t *)p->payload + optlen, remainder, offset );
+#endif /* LWIP_TUNFORGE_TCP_HOOK && TCP_CHECKSUM_ON_COPY */
+  if (copied != remainder) {
     LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_LEVEL_SERIOUS,
                 ("tcp_split_unsent_seg: could not copy pbuf remainder %u\n", remainder));
     goto memerr;
   }
-#if TCP_CHECKSUM_ON_COPY
+#if TCP_CHECKSUM_ON_COPY && !LWIP_TUNFORGE_TCP_HOOK
   /* calculate the checksum on remainder data */
   tcp_seg_add_chksum(~inet_chksum((const u8_t *)p->payload + optlen, remainder), remainder,
                      &chksum, &chksum_swapped);
-#endif /* TCP_CHECKSUM_ON_COPY */
+#endif /* TCP_CHECKSUM_ON_COPY && !LWIP_TUNFORGE_TCP_HOOK */
 
   /* Options are created when calling tcp_output() */
 
@@ -945,6 +1130,12 @@ tcp_split_unsent_seg(struct tcp_pcb *pcb, u16_t split)
   pcb->snd_queuelen += pbuf_clen(useg->p);
 
 #if TCP_CHECKSUM_ON_COPY
+#if LWIP_TUNFORGE_TCP_HOOK
+  if (useg->flags & TF_SEG_DATA_CHECKSUMMED) {
+    tcp_tunforge_chksum_trim(useg, split, chksum, chksum_swapped);
+  } else
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+  {
   /* The checksum on the split segment is now incorrect. We need to re-run it over the split */
   useg->chksum = 0;
   useg->chksum_swapped = 0;
@@ -962,6 +1153,7 @@ tcp_split_unsent_seg(struct tcp_pcb *pcb, u16_t split)
     tcp_seg_add_chksum(~inet_chksum((const u8_t *)q->payload + offset, q->len - offset), q->len - offset,
                        &useg->chksum, &useg->chksum_swapped);
   }
+  }
 #endif /* TCP_CHECKSUM_ON_COPY */
 
   /* Update number of segments on the queues. Note that length now may
@@ -1305,6 +1497,10 @@ tcp_output(struct tcp_pcb *pcb)
     ip_addr_copy(pcb->local_ip, *local_ip);
   }
 
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_gso_fit(pcb, wnd);
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
   /* Handle the current segment not fitting within the window */
   if (lwip_ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len > wnd) {
     /* We need to start the persistent timer when the next unsent segment does not fit
@@ -1348,6 +1544,16 @@ tcp_output(struct tcp_pcb *pcb)
         ((pcb->flags & (TF_NAGLEMEMERR | TF_FIN)) == 0)) {
       break;
     }
+#if LWIP_TUNFORGE_TCP_HOOK
+    /* TunForge: corked, hold back the partial tail (see tcp_tunforge_set_cork()) */
+    if ((pcb->flags & TF_TUNFORGE_CORK) && (seg->next == NULL) && (seg->len < pcb->mss) &&
+        ((pcb->flags & (TF_NAGLEMEMERR | TF_FIN)) == 0)) {
+      if (pcb->flags & TF_ACK_NOW) {
+        return tcp_send_empty_ack(pcb);
+      }
+      break;
+    }
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
 #if TCP_CWND_DEBUG
     LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %"TCPWNDSIZE_F", cwnd %"TCPWNDSIZE_F", wnd %"U32_F", effwnd %"U32_F", seq %"U32_F", ack %"U32_F", i %"S16_F"\n",
                                  pcb->snd_wnd, pcb->cwnd, wnd,
@@ -1409,6 +1615,9 @@ tcp_output(struct tcp_pcb *pcb)
     } else {
       tcp_seg_free(seg);
     }
+#if LWIP_TUNFORGE_TCP_HOOK
+    tcp_tunforge_gso_fit(pcb, wnd);
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
     seg = pcb->unsent;
   }
 #if TCP_OVERSIZE
@@ -1567,7 +1776,15 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif
 #endif
   LWIP_ASSERT("options not filled", (u8_t *)opts == ((u8_t *)(seg->tcphdr + 1)) + LWIP_TCP_OPT_LENGTH_SEGMENT(seg->flags, pcb));
 
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_gso_tx_mss = tcp_tunforge_gso_segment_mss(seg, pcb);
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
 #if CHECKSUM_GEN_TCP
+#if LWIP_TUNFORGE_TCP_HOOK
+  /* TunForge: the netif checksums every packet it cuts from a super-segment */
+  if (tcp_tunforge_gso_tx_mss == 0)
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
   IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_TCP) {
 #if TCP_CHECKSUM_ON_COPY
     u32_t acc;
@@ -1611,6 +1828,9 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif
   err = ip_output_if(seg->p, &pcb->local_ip, &pcb->remote_ip, pcb->ttl,
                      pcb->tos, IP_PROTO_TCP, netif);
   NETIF_RESET_HINTS(netif);
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcp_tunforge_gso_tx_mss = 0;
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
 
 #if TCP_CHECKSUM_ON_COPY
   if (seg_chksum_was_swapped) {
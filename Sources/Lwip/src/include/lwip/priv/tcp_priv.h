@@ -456,6 +456,16 @@ struct tcp_seg *tcp_seg_copy(struct tcp_seg *seg);
 #define tcp_ack_now(pcb)                           \
   tcp_set_flags(pcb, TF_ACK_NOW)
 
+#if LWIP_TUNFORGE_TCP_HOOK
+u8_t tcp_tunforge_defer_output(struct tcp_pcb *pcb);
+void tcp_tunforge_ack(struct tcp_pcb *pcb, u32_t len, u8_t urgent);
+void tcp_tunforge_rx_account(struct tcp_pcb *pcb);
+void tcp_tunforge_rx_unaccount(struct tcp_pcb *pcb);
+#if LWIP_SUPPORT_CUSTOM_PBUF
+struct pbuf *tcp_tunforge_pbuf_unref(struct pbuf *p, const void *hdr, u16_t hdrlen);
+#endif /* LWIP_SUPPORT_CUSTOM_PBUF */
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
 err_t tcp_send_fin(struct tcp_pcb *pcb);
 err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags);
 
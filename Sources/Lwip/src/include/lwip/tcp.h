@@ -137,12 +137,27 @@ typedef err_t (*tcp_connected_fn)(void *arg, struct tcp_pcb *tpcb, err_t err);
 #define RCV_WND_SCALE(pcb, wnd) (((wnd) >> (pcb)->rcv_scale))
 #define SND_WND_SCALE(pcb, wnd) (((wnd) << (pcb)->snd_scale))
 #define TCPWND16(x)             ((u16_t)LWIP_MIN((x), 0xFFFF))
-#define TCP_WND_MAX(pcb)        ((tcpwnd_size_t)(((pcb)->flags & TF_WND_SCALE) ? TCP_WND : TCPWND16(TCP_WND)))
+#define TCP_WND_DEFAULT(pcb)    ((tcpwnd_size_t)(((pcb)->flags & TF_WND_SCALE) ? TCP_WND : TCPWND16(TCP_WND)))
+#if LWIP_TUNFORGE_TCP_HOOK
+/* TunForge: largest window the negotiated scale can announce */
+#define TCP_WND_CEIL(pcb)       ((tcpwnd_size_t)(((pcb)->flags & TF_WND_SCALE) ? \
+                                  ((tcpwnd_size_t)0xFFFF << (pcb)->rcv_scale) : 0xFFFF))
+#endif
 #else
 #define RCV_WND_SCALE(pcb, wnd) (wnd)
 #define SND_WND_SCALE(pcb, wnd) (wnd)
 #define TCPWND16(x)             (x)
-#define TCP_WND_MAX(pcb)        TCP_WND
+#define TCP_WND_DEFAULT(pcb)    TCP_WND
+#if LWIP_TUNFORGE_TCP_HOOK
+#define TCP_WND_CEIL(pcb)       ((tcpwnd_size_t)0xFFFF)
+#endif
+#endif
+#if LWIP_TUNFORGE_TCP_HOOK
+/* TunForge: per-pcb receive window size, see tcp_tunforge_set_rcv_wnd_max() */
+#define TCP_WND_MAX(pcb)        ((pcb)->tunforge_rcv_wnd_max ? (pcb)->tunforge_rcv_wnd_max : \
+                                 TCP_WND_DEFAULT(pcb))
+#else
+#define TCP_WND_MAX(pcb)        TCP_WND_DEFAULT(pcb)
 #endif
 /* Increments a tcpwnd_size_t and holds at max value rather than rollover */
 #define TCP_WND_INC(wnd, inc)   do { \
@@ -269,6 +284,11 @@ struct tcp_pcb {
 #define TF_RTO         0x0800U /* RTO timer has fired, in-flight data moved to unsent and being retransmitted */
 #if LWIP_TCP_SACK_OUT
 #define TF_SACK        0x1000U /* Selective ACKs enabled */
+#endif
+#if LWIP_TUNFORGE_TCP_HOOK
+#define TF_TUNFORGE_OUTPUT_DEFERRED 0x2000U /* TunForge: tcp_output postponed until the input batch ends */
+#define TF_TUNFORGE_GSO             0x4000U /* TunForge: large-send, netif segments super-segments */
+#define TF_TUNFORGE_CORK            0x8000U /* TunForge: tcp_output holds back a trailing sub-MSS segment */
 #endif
 
   /* the rest of the fields are in host byte order
@@ -284,6 +304,12 @@ struct tcp_pcb {
   tcpwnd_size_t rcv_wnd;   /* receiver window available */
   tcpwnd_size_t rcv_ann_wnd; /* receiver window to announce */
   u32_t rcv_ann_right_edge; /* announced right edge of window */
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcpwnd_size_t tunforge_rcv_wnd_max; /* TunForge: receive window size, 0 = TCP_WND */
+  tcpwnd_size_t tunforge_rcv_wnd_debt; /* TunForge: consumed bytes owed to a shrink, not rcv_wnd */
+  u32_t tunforge_ooseq_bytes; /* TunForge: bytes on ->ooseq, see tcp_tunforge_rx_account() */
+  u8_t tunforge_rx_holding;   /* TunForge: counted in the flows of tcp_tunforge_rx_held() */
+#endif
 
 #if LWIP_TCP_SACK_OUT
   /* SACK ranges to include in ACK packets (entry is invalid if left==right) */
@@ -324,6 +350,12 @@ struct tcp_pcb {
   tcpwnd_size_t snd_wnd_max; /* the maximum sender window announced by the remote host */
 
   tcpwnd_size_t snd_buf;   /* Available buffer space for sending (in bytes). */
+#if LWIP_TUNFORGE_TCP_HOOK
+  tcpwnd_size_t tunforge_snd_buf_max;  /* TunForge: send buffer size, 0 = TCP_SND_BUF */
+  tcpwnd_size_t tunforge_snd_buf_debt; /* TunForge: ACKed bytes owed to a shrink, not snd_buf */
+  u16_t tunforge_ack_segs;  /* TunForge: segments received since the last ACK (stretch-ACK) */
+  u32_t tunforge_ack_bytes; /* TunForge: bytes received since the last ACK (stretch-ACK) */
+#endif
 #define TCP_SNDQUEUELEN_OVERFLOW (0xffffU-3)
   u16_t snd_queuelen; /* Number of pbufs currently in the send buffer. */
 
@@ -484,6 +516,21 @@ err_t            tcp_tcp_get_tcp_addrinfo(struct tcp_pcb *pcb, int local, ip_add
 /* for compatibility with older implementation */
 #define tcp_new_ip6() tcp_new_ip_type(IPADDR_TYPE_V6)
 
+#if LWIP_TUNFORGE_TCP_HOOK
+void tcp_tunforge_batch_begin(void);
+void tcp_tunforge_batch_end(void);
+void tcp_tunforge_set_gso(struct tcp_pcb *pcb, u8_t enable);
+void tcp_tunforge_set_cork(struct tcp_pcb *pcb, u8_t enable);
+err_t tcp_tunforge_process_refused(struct tcp_pcb *pcb);
+void tcp_tunforge_recved(struct tcp_pcb *pcb, u32_t len, u32_t threshold);
+tcpwnd_size_t tcp_tunforge_set_rcv_wnd_max(struct tcp_pcb *pcb, tcpwnd_size_t wnd_max);
+tcpwnd_size_t tcp_tunforge_set_snd_buf_max(struct tcp_pcb *pcb, tcpwnd_size_t buf_max);
+void tcp_tunforge_set_ack_policy(u16_t segs, u32_t bytes);
+u16_t tcp_tunforge_gso_mss(void);
+u32_t tcp_tunforge_rx_held(const ip_addr_t *src, u16_t sport, const ip_addr_t *dst, u16_t dport,
+                           u16_t *flows);
+#endif /* LWIP_TUNFORGE_TCP_HOOK */
+
 #if LWIP_TCP_PCB_NUM_EXT_ARGS
 u8_t tcp_ext_arg_alloc_id(void);
 void tcp_ext_arg_set_callbacks(struct tcp_pcb *pcb, u8_t id, const struct tcp_ext_arg_callbacks * const callbacks);
@@ -0,0 +1,44 @@
+//
+//  TFBufferSlab.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Fixed-capacity slab of equally sized buffers.
+///
+/// Ownership contract:
+/// - `tf_buffer_slab_acquire` / `tf_buffer_slab_wrap` MUST be called on one queue (packetsQueue).
+/// - Buffers return to the slab from the NSData deallocator, on any thread.
+///   The free list is lock-free (tagged index stack), so release never blocks.
+/// - A slab is never destroyed; it lives as long as its owner (the global TFIPStack).
+typedef struct tf_buffer_slab tf_buffer_slab;
+
+typedef struct {
+    NSUInteger capacity;
+    NSUInteger inUse;
+    NSUInteger highWater;  // max buffers simultaneously in use
+    uint64_t exhaustions;  // acquire attempts that found the slab empty
+} tf_buffer_slab_stats;
+
+tf_buffer_slab *_Nullable tf_buffer_slab_create(NSUInteger capacity, NSUInteger bufferSize);
+
+NSUInteger tf_buffer_slab_buffer_size(const tf_buffer_slab *slab);
+
+/// Returns a free buffer, or NULL if the slab is exhausted (counted).
+void *_Nullable tf_buffer_slab_acquire(tf_buffer_slab *slab);
+
+/// Wraps an acquired buffer without copying; the buffer returns to the slab when the
+/// NSData is deallocated.
+NSData *tf_buffer_slab_wrap(tf_buffer_slab *slab, void *buffer, NSUInteger length);
+
+/// Returns an acquired buffer that was not wrapped.
+void tf_buffer_slab_release(tf_buffer_slab *slab, void *buffer);
+
+tf_buffer_slab_stats tf_buffer_slab_get_stats(const tf_buffer_slab *slab);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,134 @@
+//
+//  TFBufferSlab.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFBufferSlab.h"
+
+#import <stdatomic.h>
+
+// Free list head: (tag << 32) | (index + 1); 0 means empty.
+// The tag is bumped on every successful pop/push to defeat ABA.
+#define TF_SLAB_EMPTY 0u
+
+struct tf_buffer_slab {
+    NSUInteger capacity;
+    NSUInteger bufferSize;
+    uint8_t *storage;
+    _Atomic uint32_t *next; // per buffer: next free (index + 1), 0 terminates
+    _Atomic uint64_t head;
+
+    _Atomic NSUInteger inUse;
+    _Atomic NSUInteger highWater;
+    _Atomic uint64_t exhaustions;
+};
+
+static inline uint32_t tf_slab_index_of(const tf_buffer_slab *slab, const void *buffer) {
+    return (uint32_t)(((const uint8_t *)buffer - slab->storage) / slab->bufferSize);
+}
+
+static void tf_slab_push(tf_buffer_slab *slab, uint32_t index) {
+    uint64_t old = atomic_load_explicit(&slab->head, memory_order_relaxed);
+    for (;;) {
+        atomic_store_explicit(&slab->next[index], (uint32_t)old, memory_order_relaxed);
+        uint64_t tag = (old >> 32) + 1;
+        uint64_t new = (tag << 32) | (uint64_t)(index + 1);
+        if (atomic_compare_exchange_weak_explicit(
+                &slab->head, &old, new, memory_order_release, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+static BOOL tf_slab_pop(tf_buffer_slab *slab, uint32_t *index) {
+    uint64_t old = atomic_load_explicit(&slab->head, memory_order_acquire);
+    for (;;) {
+        uint32_t top = (uint32_t)old;
+        if (top == TF_SLAB_EMPTY)
+            return NO;
+
+        uint32_t next = atomic_load_explicit(&slab->next[top - 1], memory_order_relaxed);
+        uint64_t tag = (old >> 32) + 1;
+        uint64_t new = (tag << 32) | (uint64_t)next;
+        if (atomic_compare_exchange_weak_explicit(
+                &slab->head, &old, new, memory_order_acquire, memory_order_acquire)) {
+            *index = top - 1;
+            return YES;
+        }
+    }
+}
+
+tf_buffer_slab *tf_buffer_slab_create(NSUInteger capacity, NSUInteger bufferSize) {
+    if (capacity == 0 || capacity >= UINT32_MAX || bufferSize == 0)
+        return NULL;
+
+    tf_buffer_slab *slab = (tf_buffer_slab *)calloc(1, sizeof(tf_buffer_slab));
+    if (!slab)
+        return NULL;
+
+    slab->capacity = capacity;
+    slab->bufferSize = bufferSize;
+    slab->storage = (uint8_t *)malloc(capacity * bufferSize);
+    slab->next = (_Atomic uint32_t *)calloc(capacity, sizeof(_Atomic uint32_t));
+    if (!slab->storage || !slab->next) {
+        free(slab->storage);
+        free((void *)slab->next);
+        free(slab);
+        return NULL;
+    }
+
+    atomic_init(&slab->head, TF_SLAB_EMPTY);
+    for (NSUInteger i = capacity; i > 0; i--) {
+        tf_slab_push(slab, (uint32_t)(i - 1));
+    }
+    return slab;
+}
+
+NSUInteger tf_buffer_slab_buffer_size(const tf_buffer_slab *slab) {
+    return slab->bufferSize;
+}
+
+void *tf_buffer_slab_acquire(tf_buffer_slab *slab) {
+    uint32_t index = 0;
+    if (!tf_slab_pop(slab, &index)) {
+        atomic_fetch_add_explicit(&slab->exhaustions, 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    NSUInteger inUse = atomic_fetch_add_explicit(&slab->inUse, 1, memory_order_relaxed) + 1;
+    // Single acquiring queue: plain load/store is enough for the high-water mark.
+    if (inUse > atomic_load_explicit(&slab->highWater, memory_order_relaxed)) {
+        atomic_store_explicit(&slab->highWater, inUse, memory_order_relaxed);
+    }
+    return slab->storage + (NSUInteger)index * slab->bufferSize;
+}
+
+void tf_buffer_slab_release(tf_buffer_slab *slab, void *buffer) {
+    NSCParameterAssert((uint8_t *)buffer >= slab->storage &&
+                       (uint8_t *)buffer < slab->storage + slab->capacity * slab->bufferSize);
+
+    atomic_fetch_sub_explicit(&slab->inUse, 1, memory_order_relaxed);
+    tf_slab_push(slab, tf_slab_index_of(slab, buffer));
+}
+
+NSData *tf_buffer_slab_wrap(tf_buffer_slab *slab, void *buffer, NSUInteger length) {
+    NSCParameterAssert(length <= slab->bufferSize);
+
+    return [[NSData alloc] initWithBytesNoCopy:buffer
+                                        length:length
+                                   deallocator:^(void *bytes, NSUInteger len) {
+                                       (void)len;
+                                       tf_buffer_slab_release(slab, bytes);
+                                   }];
+}
+
+tf_buffer_slab_stats tf_buffer_slab_get_stats(const tf_buffer_slab *slab) {
+    tf_buffer_slab_stats stats;
+    stats.capacity = slab->capacity;
+    stats.inUse = atomic_load_explicit(&slab->inUse, memory_order_relaxed);
+    stats.highWater = atomic_load_explicit(&slab->highWater, memory_order_relaxed);
+    stats.exhaustions = atomic_load_explicit(&slab->exhaustions, memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,32 @@
+//
+//  TFEgressFence.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Orders work after every zero-copy egress batch that may still point into lwIP pbufs.
+///
+/// The zero-copy egress path holds pbuf references until the upper layer completes a batch,
+/// so a pbuf lwIP has already freed (e.g. an ACKed segment) can still be read there.
+/// Whatever backs such a pbuf's payload MUST outlive those batches: each batch holds a
+/// fence, and tf_egress_fence_after() waits for every fence open at the time of the call.
+///
+/// Threading:
+/// - Everything here MUST be used on packetsQueue.
+typedef NSUInteger tf_egress_fence;
+
+/// Opens a fence; pair with exactly one tf_egress_fence_close().
+tf_egress_fence tf_egress_fence_open(void);
+
+/// Closes `fence`, running waiters no longer held back by any open fence.
+void tf_egress_fence_close(tf_egress_fence fence);
+
+/// Runs `block` once every fence open now is closed; immediately if none is.
+void tf_egress_fence_after(dispatch_block_t block);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,78 @@
+//
+//  TFEgressFence.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFEgressFence.h"
+#import "TFQueueHelpers.h"
+
+typedef struct tf_egress_fence_waiter {
+    struct tf_egress_fence_waiter *next;
+    tf_egress_fence fence; // newest fence open when enqueued
+    void *block;           // +1 dispatch_block_t
+} tf_egress_fence_waiter;
+
+// packetsQueue-owned state.
+static tf_egress_fence tf_fence_last;
+static NSMutableIndexSet *tf_fence_open_set;
+static tf_egress_fence_waiter *tf_fence_waiters_head;
+static tf_egress_fence_waiter *tf_fence_waiters_tail;
+
+tf_egress_fence tf_egress_fence_open(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tf_fence_open_set) {
+        tf_fence_open_set = [NSMutableIndexSet indexSet];
+    }
+    tf_egress_fence fence = ++tf_fence_last;
+    [tf_fence_open_set addIndex:fence];
+    return fence;
+}
+
+void tf_egress_fence_close(tf_egress_fence fence) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    [tf_fence_open_set removeIndex:fence];
+
+    // Waiters are ordered by fence: run the prefix older than the oldest open fence.
+    tf_egress_fence oldest = tf_fence_open_set.count ? tf_fence_open_set.firstIndex : NSNotFound;
+    while (tf_fence_waiters_head && tf_fence_waiters_head->fence < oldest) {
+        tf_egress_fence_waiter *waiter = tf_fence_waiters_head;
+        tf_fence_waiters_head = waiter->next;
+        if (!tf_fence_waiters_head) {
+            tf_fence_waiters_tail = NULL;
+        }
+
+        dispatch_block_t block = (__bridge_transfer dispatch_block_t)waiter->block;
+        free(waiter);
+        block();
+    }
+}
+
+void tf_egress_fence_after(dispatch_block_t block) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (tf_fence_open_set.count == 0) {
+        block();
+        return;
+    }
+
+    tf_egress_fence_waiter *waiter = malloc(sizeof(*waiter));
+    if (!waiter) {
+        // fallback: run now rather than leak the caller's buffer
+        block();
+        return;
+    }
+
+    waiter->next = NULL;
+    waiter->fence = tf_fence_last;
+    waiter->block = (__bridge_retained void *)[block copy];
+    if (tf_fence_waiters_tail) {
+        tf_fence_waiters_tail->next = waiter;
+    } else {
+        tf_fence_waiters_head = waiter;
+    }
+    tf_fence_waiters_tail = waiter;
+}
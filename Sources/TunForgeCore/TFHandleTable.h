@@ -0,0 +1,59 @@
+//
+//  TFHandleTable.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Generation-indexed handles for passing ObjC objects through lwIP's `void *` slots
+/// (tcp_arg callback_arg, tcp_ext_arg) without bridging object pointers.
+///
+/// A handle packs {generation, slot}. Freeing a slot bumps its generation, so every handle
+/// issued for it before goes stale; resolving one is a bounds check and a compare, with no
+/// message send and no weak-reference load. 0 is never a valid handle.
+///
+/// Ownership contract:
+/// - The table holds +1 on the object from tf_handle_alloc() until tf_handle_free(); that
+///   reference is dropped on a later packetsQueue turn, so freeing from inside the object's
+///   own method is safe.
+///
+/// Threading:
+/// - Everything here MUST be used on packetsQueue.
+typedef uintptr_t tf_handle;
+
+typedef struct {
+    uintptr_t generation; // masked to the handle's generation bits, never 0
+    void *_Nullable object; // +1 while allocated
+    uint32_t nextFree;
+} tf_handle_entry;
+
+enum { kTFHandleSlotBits = 20 }; // up to 1M live handles
+
+/// packetsQueue only; read by tf_handle_get().
+extern tf_handle_entry *_Nullable tf_handle_entries;
+extern uint32_t tf_handle_capacity;
+
+/// Registers `object` and returns its handle, or 0 if out of memory.
+tf_handle tf_handle_alloc(id object);
+
+/// Invalidates `handle` (no-op if already stale) and drops the table's reference.
+void tf_handle_free(tf_handle handle);
+
+/// The object registered under `handle`, or nil if the handle is stale or invalid.
+static inline id _Nullable tf_handle_get(tf_handle handle) {
+    uintptr_t slot = handle & (((uintptr_t)1 << kTFHandleSlotBits) - 1);
+    if (slot >= tf_handle_capacity)
+        return nil;
+
+    tf_handle_entry *entry = &tf_handle_entries[slot];
+    if (entry->generation != handle >> kTFHandleSlotBits)
+        return nil;
+
+    return (__bridge id)entry->object;
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,82 @@
+//
+//  TFHandleTable.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFHandleTable.h"
+#import "TFQueueHelpers.h"
+
+static const uint32_t kTFHandleInitialCapacity = 64;
+static const uint32_t kTFHandleMaxCapacity = (uint32_t)1 << kTFHandleSlotBits;
+static const uint32_t kTFHandleNoFree = UINT32_MAX;
+static const uintptr_t kTFHandleGenerationMask = UINTPTR_MAX >> kTFHandleSlotBits;
+
+tf_handle_entry *tf_handle_entries;
+uint32_t tf_handle_capacity;
+
+// packetsQueue only.
+static uint32_t tf_handle_free_head = kTFHandleNoFree;
+
+/// Doubles the table, threading the new slots onto the free list.
+static BOOL tf_handle_grow(void) {
+    if (tf_handle_capacity >= kTFHandleMaxCapacity)
+        return NO;
+
+    uint32_t capacity = tf_handle_capacity ? 2 * tf_handle_capacity : kTFHandleInitialCapacity;
+    capacity = MIN(capacity, kTFHandleMaxCapacity);
+    tf_handle_entry *entries = realloc(tf_handle_entries, capacity * sizeof(tf_handle_entry));
+    if (!entries)
+        return NO;
+
+    for (uint32_t i = tf_handle_capacity; i < capacity; i++) {
+        entries[i].generation = 1;
+        entries[i].object = NULL;
+        entries[i].nextFree = (i + 1 < capacity) ? i + 1 : tf_handle_free_head;
+    }
+    tf_handle_free_head = tf_handle_capacity;
+    tf_handle_entries = entries;
+    tf_handle_capacity = capacity;
+    return YES;
+}
+
+tf_handle tf_handle_alloc(id object) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    NSCParameterAssert(object);
+
+    if (tf_handle_free_head == kTFHandleNoFree && !tf_handle_grow())
+        return 0;
+
+    uint32_t slot = tf_handle_free_head;
+    tf_handle_entry *entry = &tf_handle_entries[slot];
+    tf_handle_free_head = entry->nextFree;
+
+    entry->object = (__bridge_retained void *)object;
+    entry->nextFree = kTFHandleNoFree;
+    return (entry->generation << kTFHandleSlotBits) | slot;
+}
+
+void tf_handle_free(tf_handle handle) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tf_handle_get(handle))
+        return;
+
+    uint32_t slot = (uint32_t)(handle & (kTFHandleMaxCapacity - 1));
+    tf_handle_entry *entry = &tf_handle_entries[slot];
+    id object = (__bridge_transfer id)entry->object;
+
+    entry->object = NULL;
+    entry->generation = (entry->generation + 1) & kTFHandleGenerationMask;
+    if (entry->generation == 0) {
+        entry->generation = 1;
+    }
+    entry->nextFree = tf_handle_free_head;
+    tf_handle_free_head = slot;
+
+    // The caller may be running a method of `object`: let it finish first.
+    tf_packets_defer(^{
+        (void)object;
+    });
+}
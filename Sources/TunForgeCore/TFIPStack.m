@@ -6,9 +6,18 @@
 //
 
 #import "TFIPStack.h"
+#import "TFBufferSlab.h"
+#import "TFEgressFence.h"
 #import "TFGlobalScheduler.h"
 #import "TFObjectRef.h"
+#import "TFPacketClassifier.h"
+#import "TFPacketsTurn.h"
 #import "TFQueueHelpers.h"
+#import "TFReceiveOffload.h"
+#import "TFReceiveWindow.h"
+#import "TFSendBuffer.h"
+#import "TFSegmentationOffload.h"
+#import "TFSliceSlab.h"
 #import "TFTCPConnection.h"
 #import "TFTunForgeLog.h"
 #import "TFWeakifyStrongify.h"
@@ -16,7 +25,12 @@
 #import "lwip/err.h"
 #import "lwip/init.h"
 #import "lwip/ip4_addr.h"
+#import "lwip/memp.h"
 #import "lwip/netif.h"
+#import "lwip/pbuf.h"
+#import "lwip/prot/ip4.h"
+#import "lwip/prot/tcp.h"
+#import "lwip/stats.h"
 #import "lwip/tcp.h"
 #import "lwip/timeouts.h"
 #import <netinet/in.h>
@@ -33,7 +47,82 @@ static err_t tunforge_netif_init(struct netif *netif);
 
 static void tunforge_netif_setup(void *state);
 
-@interface TFIPStack ()
+#pragma mark - Zero-copy ingress pbufs
+
+/// PBUF_REF custom pbuf wrapping a caller-owned packet buffer.
+typedef struct {
+    struct pbuf_custom custom;
+    const void *owner; // retained NSData or TFPacketReleaseHandler
+} tf_ingress_ref_pbuf;
+
+LWIP_MEMPOOL_DECLARE(TF_INGRESS_REF_PBUF,
+                     PBUF_POOL_SIZE,
+                     sizeof(tf_ingress_ref_pbuf),
+                     "TunForge ingress ref pbuf");
+
+static inline BOOL tf_ip4_is_fragment(const void *bytes, u16_t len);
+static struct pbuf *tf_ingress_pbuf_wrap(const void *bytes, u16_t len, id owner);
+
+static struct pbuf *tf_gro_alloc(void *ctx, const void *bytes, u16_t len, void *owner);
+static void tf_gro_input(void *ctx, struct pbuf *p);
+
+#pragma mark - Ingress admission control
+
+typedef enum {
+    TF_ADMISSION_CONTROL = 0, // ACK / FIN / RST without payload
+    TF_ADMISSION_SYN,         // connection attempt
+    TF_ADMISSION_DATA,        // TCP segment carrying payload
+    TF_ADMISSION_OTHER        // non-TCP, fragment or unparsable
+} tf_admission_class;
+
+typedef struct {
+    ip_addr_t src;
+    ip_addr_t dst;
+    u16_t sport;
+    u16_t dport;
+    u16_t payloadLength;
+} tf_admission_segment;
+
+/// Receive-side bytes the pbuf pool can hold; split evenly across flows holding any.
+static const u32_t kTFAdmissionPoolBytes = (u32_t)PBUF_POOL_SIZE * PBUF_POOL_BUFSIZE;
+
+static tf_admission_class tf_admission_classify(const uint8_t *bytes,
+                                                u16_t len,
+                                                tf_admission_segment *segment);
+static double tf_admission_pool_usage(void);
+static double tf_admission_heap_usage(void);
+
+/// Upper bound of packets held back for one outboundHandler call.
+static const NSUInteger kTFEgressBatchMaxPackets = 256;
+
+/// Zero-copy egress batch, one allocation:
+/// [tf_egress_batch][struct pbuf * x count][TFPacketDescriptor x packetCount]
+/// [TFBytesSlice x n][GSO header x h].
+typedef struct {
+    NSUInteger count;
+    NSUInteger packetCount;
+    struct pbuf **pbufs;
+    TFPacketDescriptor *packets;
+    TFBytesSlice *slices;
+    u8_t *headers; // TF_GSO_HEADER_MAX bytes per packet cut from a super-segment
+    tf_egress_fence fence; // held until the upper layer completes the batch
+} tf_egress_batch;
+
+static void tf_egress_batch_free(tf_egress_batch *batch);
+static NSUInteger tf_egress_slices(struct pbuf *p, u16_t offset, u16_t len, TFBytesSlice *slices);
+
+/// Recycled MTU-sized buffers backing the NSData egress path.
+/// Sized for two full egress batches in flight at the upper layer.
+static const NSUInteger kTFEgressSlabCapacity = 2 * kTFEgressBatchMaxPackets;
+
+@interface TFIPStack () <TFPacketsTurnObserver> {
+    // Counters owned by packetsQueue; slab counters are read from the slab itself.
+    TFIPStackStatistics _stats;
+
+    // Receive offload state of the current input batch.
+    tf_gro _gro;
+    BOOL _receiveOffloadActive;
+}
 
 @property (nonatomic, assign) void *state;
 @property (nonatomic, assign) BOOL ready;
@@ -42,6 +131,21 @@ static void tunforge_netif_setup(void *state);
 @property (nonatomic, strong) dispatch_source_t timer;
 @property (nonatomic, assign) struct tcp_pcb *listener;
 
+// Egress packets of the current packetsQueue turn.
+@property (nonatomic, strong) NSMutableArray<NSData *> *pendingPackets;
+
+// Zero-copy egress pbufs (pbuf_ref'ed) of the current packetsQueue turn.
+@property (nonatomic, assign) struct pbuf **pendingPbufs;
+@property (nonatomic, assign) u16_t *pendingPbufGsoMss; // 0: regular packet
+@property (nonatomic, assign) NSUInteger pendingPbufCount;
+@property (nonatomic, assign) NSUInteger pendingPbufPacketCount;
+@property (nonatomic, assign) NSUInteger pendingPbufSliceCount;
+@property (nonatomic, assign) NSUInteger pendingPbufHeaderCount;
+@property (nonatomic, assign) tf_egress_fence pendingPbufFence; // open while any pbuf is pending
+
+// NSData egress buffers; never destroyed (lives with the global stack).
+@property (nonatomic, assign) tf_buffer_slab *egressSlab;
+
 @end
 
 @implementation TFIPStack
@@ -67,7 +171,20 @@ static TFIPStack *_stack;
     if (self = [super init]) {
         [TFGlobalScheduler.shared packetsPerformSync:^{
             _stackRef = [[TFObjectRef alloc] initWithObject:self];
+            _pendingPackets = [NSMutableArray array];
+            _pendingPbufs = calloc(kTFEgressBatchMaxPackets, sizeof(struct pbuf *));
+            _pendingPbufGsoMss = calloc(kTFEgressBatchMaxPackets, sizeof(u16_t));
+            _egressSlab = tf_buffer_slab_create(kTFEgressSlabCapacity, TUNFORGE_NETIF_IPV4_MTU);
+            _admissionLowWatermark = 0.75;
+            _admissionHighWatermark = 0.9;
+            _admissionHeapLowWatermark = 0.85;
+            _admissionHeapHighWatermark = 0.95;
+            _receiveWindowBudget = kTFAdmissionPoolBytes;
+            _sendBufferBudget = MEM_SIZE / 4;
+            tf_gro_ops groOps = {tf_gro_alloc, tf_gro_input, (__bridge void *)self};
+            tf_gro_init(&_gro, &groOps);
             lwip_init();
+            LWIP_MEMPOOL_INIT(TF_INGRESS_REF_PBUF);
             memset(&tunforge_virtual_netif, 0, sizeof(tunforge_virtual_netif));
         }];
     }
@@ -96,7 +213,9 @@ static TFIPStack *_stack;
     dispatch_source_set_timer(
         timer, DISPATCH_TIME_NOW, (uint64_t)TCP_TMR_INTERVAL * NSEC_PER_MSEC, 0);
     dispatch_source_set_event_handler(timer, ^{
+        TFPacketsTurnBegin();
         sys_check_timeouts();
+        TFPacketsTurnEnd();
     });
 
     sys_restart_timeouts();
@@ -117,6 +236,8 @@ static TFIPStack *_stack;
         self.timer = nil;
     }
 
+    [self flushOutboundLocked];
+
     [self.stackRef invalidate];
     self.stackRef = nil;
     self.ready = NO;
@@ -149,68 +270,627 @@ static TFIPStack *_stack;
         return;
     }
 
-    u16_t len = packet.length;
-    if (len == 0 || len > UINT16_MAX) {
+    if (![self canInputLocked])
         return;
-    }
 
-    if (!self.stackRef.alive)
+    TFPacketsTurnBegin();
+    [self inputDataLocked:packet];
+    TFPacketsTurnEnd();
+}
+
+/// Batched input (TUN -> LwIP).
+/// lwIP defers ACK / window-update output until the whole batch is consumed.
+- (void)inputPackets:(NSArray<NSData *> *)packets {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (packets.count == 0)
         return;
-    if (!self.ready)
+
+    if (![self canInputLocked])
         return;
 
-    if (!tunforge_virtual_netif.input)
+    TFPacketsTurnBegin();
+    [self applyAckPolicyLocked];
+    tcp_tunforge_batch_begin();
+    [self beginReceiveOffloadLocked];
+    for (NSData *packet in packets) {
+        [self inputDataLocked:packet];
+    }
+    [self endReceiveOffloadLocked];
+    tcp_tunforge_batch_end();
+    TFPacketsTurnEnd();
+}
+
+- (void)inputPacketSlices:(const TFBytesSlice *)slices count:(NSUInteger)count {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!slices || count == 0)
         return;
 
-    // TODO:
-    //    if (pbuf_pool_low()) {
-    //        // drop + log
-    //        return;
-    //    }
+    if (![self canInputLocked])
+        return;
+
+    TFPacketsTurnBegin();
+    [self applyAckPolicyLocked];
+    tcp_tunforge_batch_begin();
+    [self beginReceiveOffloadLocked];
+    for (NSUInteger i = 0; i < count; i++) {
+        [self inputBytesLocked:slices[i].bytes length:slices[i].length packet:nil owner:nil];
+    }
+    [self endReceiveOffloadLocked];
+    tcp_tunforge_batch_end();
+    TFPacketsTurnEnd();
+}
+
+- (void)inputPacketBytesNoCopy:(void *)bytes
+                        length:(NSUInteger)length
+                       release:(TFPacketReleaseHandler)release {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    BOOL handedOff = NO;
+    if (bytes && [self canInputLocked]) {
+        TFPacketsTurnBegin();
+        handedOff = [self inputBytesLocked:bytes length:length packet:nil owner:release];
+        TFPacketsTurnEnd();
+    }
+
+    if (!handedOff && release) {
+        release();
+    }
+}
+
+- (TFIPStackStatistics)statistics {
+    __block TFIPStackStatistics stats;
+    [TFGlobalScheduler.shared packetsPerformSync:^{
+        stats = self->_stats;
+        stats.ingressCoalescedSegments = self->_gro.coalesced;
+
+        tf_slice_stats slices = tf_slices_get_stats();
+        stats.receiveSlicesInline = slices.inlineHits;
+        stats.receiveSlicesSlab = slices.slabHits;
+        stats.receiveSlicesHeap = slices.heapFallbacks;
+    }];
+
+    if (self.egressSlab) {
+        tf_buffer_slab_stats slab = tf_buffer_slab_get_stats(self.egressSlab);
+        stats.egressSlabCapacity = slab.capacity;
+        stats.egressSlabInUse = slab.inUse;
+        stats.egressSlabHighWater = slab.highWater;
+        stats.egressSlabExhaustions = slab.exhaustions;
+    }
+    return stats;
+}
+
+/// Receive offload only spans batched input; the batch end flushes every held flow.
+/// Stretch-ACK policy only applies inside input batches; refreshed as each one opens.
+- (void)applyAckPolicyLocked {
+    tcp_tunforge_set_ack_policy((u16_t)MIN(self.stretchAckSegments, (NSUInteger)UINT16_MAX),
+                                (u32_t)MIN(self.stretchAckBytes, (NSUInteger)UINT32_MAX));
+}
+
+- (void)beginReceiveOffloadLocked {
+    _receiveOffloadActive = self.receiveOffloadEnabled;
+}
+
+- (void)endReceiveOffloadLocked {
+    if (_receiveOffloadActive) {
+        tf_gro_flush(&_gro);
+        _receiveOffloadActive = NO;
+    }
+}
+
+- (BOOL)canInputLocked {
+    if (!self.stackRef.alive)
+        return NO;
+    if (!self.ready)
+        return NO;
+
+    return tunforge_virtual_netif.input != NULL;
+}
+
+/// ZeroCopy only wraps NSMutableData: lwIP (and receive offload) rewrite headers in place,
+/// and writing through an immutable NSData's storage (literal, mmap, dispatch_data backed)
+/// is undefined. Anything else is copied.
+- (nullable NSMutableData *)ingressOwnerOf:(NSData *)packet {
+    if (self.ingressMode != TFIPStackIngressModeZeroCopy)
+        return nil;
+    return [packet isKindOfClass:[NSMutableData class]] ? (NSMutableData *)packet : nil;
+}
+
+- (void)inputDataLocked:(NSData *)packet {
+    NSMutableData *owner = [self ingressOwnerOf:packet];
+    [self inputBytesLocked:owner ? owner.mutableBytes : packet.bytes
+                    length:packet.length
+                    packet:packet
+                     owner:owner];
+}
+
+/// Feeds one packet into the netif.
+/// `packet` is the NSData backing `bytes`, if any (diverted without a copy).
+/// `owner` (NSData or TFPacketReleaseHandler) keeps `bytes` alive while lwIP references them in
+/// place; nil means the bytes are only borrowed and get copied into the pbuf pool.
+/// Returns YES if `owner` was handed off (to a pbuf or a diverted NSData).
+- (BOOL)inputBytesLocked:(const void *)bytes
+                  length:(NSUInteger)length
+                  packet:(nullable NSData *)packet
+                   owner:(nullable id)owner {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    TFPacketClass packetClass = tf_packet_classify(bytes, length);
+    if (packetClass != TFPacketClassTCP) {
+        return [self rejectBytesLocked:bytes
+                                length:length
+                                packet:packet
+                                 owner:owner
+                           packetClass:packetClass];
+    }
+    u16_t len = (u16_t)length;
+
+    if (![self admitInboundLocked:bytes length:len]) {
+        return NO;
+    }
+
+    // IP reassembly writes into fragment headers and holds them for a while: always copy.
+    if (owner && tf_ip4_is_fragment(bytes, len)) {
+        owner = nil;
+    }
+
+    if (_receiveOffloadActive && tf_gro_offer(&_gro, bytes, len, (__bridge void *)owner)) {
+        return NO;
+    }
 
-    struct pbuf *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    BOOL handedOff = NO;
+    struct pbuf *pbuf = [self ingressPbufLocked:bytes length:len owner:owner handedOff:&handedOff];
     if (!pbuf) {
-        [TFTunForgeLog warn:@"pbuf_alloc failed"];
-        return;
+        return NO;
     }
 
-    err_t err = pbuf_take(pbuf, packet.bytes, len);
-    if (err != ERR_OK) {
-        pbuf_free(pbuf);
-        return;
+    [self netifInputLocked:pbuf];
+    return handedOff;
+}
+
+/// Wraps `bytes` in a PBUF_REF pbuf retaining `owner`, or copies them into the pbuf pool.
+- (nullable struct pbuf *)ingressPbufLocked:(const void *)bytes
+                                     length:(u16_t)len
+                                      owner:(nullable id)owner
+                                  handedOff:(nullable BOOL *)handedOff {
+    struct pbuf *pbuf = NULL;
+    if (owner) {
+        pbuf = tf_ingress_pbuf_wrap(bytes, len, owner);
+        if (pbuf && handedOff) {
+            *handedOff = YES;
+        }
     }
 
-    err = tunforge_virtual_netif.input(pbuf, &tunforge_virtual_netif);
+    if (!pbuf) {
+        pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+        if (!pbuf) {
+            _stats.ingressAllocFailures++;
+            [TFTunForgeLog warn:@"pbuf_alloc failed"];
+            return NULL;
+        }
+
+        err_t err = pbuf_take(pbuf, bytes, len);
+        if (err != ERR_OK) {
+            pbuf_free(pbuf);
+            return NULL;
+        }
+    }
+    return pbuf;
+}
+
+/// Feeds a complete packet to the netif; takes ownership of `pbuf`.
+- (void)netifInputLocked:(struct pbuf *)pbuf {
+    err_t err = tunforge_virtual_netif.input(pbuf, &tunforge_virtual_netif);
     if (err != ERR_OK) {
         [TFTunForgeLog warn:@"netif->input failed"];
         pbuf_free(pbuf);
     }
 }
 
+/// Drops or diverts a packet the pre-classifier rejected. Same return contract as
+/// `inputBytesLocked:length:packet:owner:`.
+- (BOOL)rejectBytesLocked:(const void *)bytes
+                   length:(NSUInteger)length
+                   packet:(nullable NSData *)packet
+                    owner:(nullable id)owner
+              packetClass:(TFPacketClass)packetClass {
+    switch (packetClass) {
+    case TFPacketClassUDP:
+        _stats.ingressUDP++;
+        break;
+    case TFPacketClassICMP:
+        _stats.ingressICMP++;
+        break;
+    case TFPacketClassIPv6:
+        _stats.ingressIPv6++;
+        break;
+    case TFPacketClassOther:
+        _stats.ingressOtherProtocol++;
+        break;
+    case TFPacketClassTCP:
+    case TFPacketClassMalformed:
+        _stats.ingressMalformed++;
+        return NO;
+    }
+
+    TFPacketDivertHandler divertHandler = self.divertHandler;
+    if (!divertHandler) {
+        return NO;
+    }
+
+    BOOL handedOff = NO;
+    if (!packet && owner) {
+        if ([owner isKindOfClass:[NSData class]]) {
+            packet = owner;
+        } else {
+            // Hand the caller's buffer over; its release handler runs when the NSData dies.
+            TFPacketReleaseHandler release = owner;
+            packet = [[NSData alloc] initWithBytesNoCopy:(void *)bytes
+                                                  length:length
+                                             deallocator:^(void *b, NSUInteger l) {
+                                                 (void)b;
+                                                 (void)l;
+                                                 [TFGlobalScheduler.shared
+                                                     packetsPerformAsync:release];
+                                             }];
+            handedOff = YES;
+        }
+    }
+    if (!packet) {
+        packet = [NSData dataWithBytes:bytes length:length];
+    }
+
+    _stats.ingressDiverted++;
+    divertHandler(packet, packetClass);
+    return handedOff;
+}
+
+/// Sheds inbound packets under pbuf pool / heap pressure, cheapest to lose first.
+/// Returns NO if the packet must be dropped (counted per class).
+- (BOOL)admitInboundLocked:(const void *)bytes length:(u16_t)len {
+    double pool = tf_admission_pool_usage();
+    double heap = tf_admission_heap_usage();
+    if (pool < self.admissionLowWatermark && heap < self.admissionHeapLowWatermark) {
+        return YES;
+    }
+
+    BOOL high = pool >= self.admissionHighWatermark || heap >= self.admissionHeapHighWatermark;
+    tf_admission_segment segment;
+    switch (tf_admission_classify(bytes, len, &segment)) {
+    case TF_ADMISSION_CONTROL:
+        return YES;
+
+    case TF_ADMISSION_SYN:
+        _stats.admissionDroppedSyn++;
+        return NO;
+
+    case TF_ADMISSION_OTHER:
+        if (!high) {
+            return YES;
+        }
+        _stats.admissionDroppedOther++;
+        return NO;
+
+    case TF_ADMISSION_DATA: {
+        if (!high) {
+            return YES;
+        }
+        u16_t flows = 0;
+        u32_t held = tcp_tunforge_rx_held(
+            &segment.src, segment.sport, &segment.dst, segment.dport, &flows);
+        u32_t share = kTFAdmissionPoolBytes / MAX(flows, 1);
+        if (held + segment.payloadLength <= share) {
+            return YES;
+        }
+        _stats.admissionDroppedData++;
+        return NO;
+    }
+    }
+    return YES;
+}
+
 /// Output (lwIP -> TUN).
 /// Observes pbuf contents synchronously.
 /// Does NOT take ownership of pbuf; lwIP will free it.
+/// Packets are handed to the outbound handler in one batch when the packetsQueue turn ends.
 - (void)outputPacket:(struct pbuf *)pbuf {
     TF_ASSERT_ON_PACKETS_QUEUE();
     if (!pbuf)
         return;
-    
+
     u16_t len = pbuf->tot_len;
-    if (len < 20 || !self.outboundHandler) {
+    if (len < 20) {
+        return;
+    }
+
+    // Non-zero while lwIP outputs a large-send super-segment.
+    u16_t gsoMss = tcp_tunforge_gso_mss();
+
+    if (self.outboundBytesHandler) {
+        [self enqueueOutboundPbufLocked:pbuf gsoMss:gsoMss];
+        return;
+    }
+
+    if (!self.outboundHandler) {
         return;
     }
 
-    NSMutableData *data = [NSMutableData dataWithLength:len];
-    u16_t ret = pbuf_copy_partial(pbuf, data.mutableBytes, len, 0);
+    if (gsoMss) {
+        [self segmentOutboundDataLocked:pbuf mss:gsoMss];
+        return;
+    }
+
+    NSData *data = [self outboundDataFromPbufLocked:pbuf length:len];
+    if (!data) {
+        _stats.egressAllocFailures++;
+        return;
+    }
+    [self enqueueOutboundDataLocked:data];
+}
+
+- (void)enqueueOutboundDataLocked:(NSData *)data {
+    [self.pendingPackets addObject:data];
+    if (self.pendingPackets.count >= kTFEgressBatchMaxPackets) {
+        [self flushOutboundDataLocked];
+    } else if (self.pendingPackets.count == 1) {
+        TFPacketsTurnEnlist(self, TFPacketsTurnStageEgress);
+    }
+}
+
+/// Returns a `len` byte egress buffer: a recycled slab buffer when one is free and large
+/// enough, a heap buffer otherwise. Hand it to `outboundDataWithBuffer:` or release it
+/// with `releaseOutboundBuffer:`.
+- (nullable void *)acquireOutboundBufferLocked:(u16_t)len fromSlab:(BOOL *)fromSlab {
+    tf_buffer_slab *slab = self.egressSlab;
+    if (slab && len <= tf_buffer_slab_buffer_size(slab)) {
+        void *buffer = tf_buffer_slab_acquire(slab);
+        if (buffer) {
+            *fromSlab = YES;
+            return buffer;
+        }
+    }
+
+    *fromSlab = NO;
+    return malloc(len);
+}
+
+- (NSData *)outboundDataWithBuffer:(void *)buffer length:(u16_t)len fromSlab:(BOOL)fromSlab {
+    if (fromSlab) {
+        return tf_buffer_slab_wrap(self.egressSlab, buffer, len);
+    }
+    return [NSData dataWithBytesNoCopy:buffer length:len freeWhenDone:YES];
+}
+
+- (void)releaseOutboundBuffer:(void *)buffer fromSlab:(BOOL)fromSlab {
+    if (fromSlab) {
+        tf_buffer_slab_release(self.egressSlab, buffer);
+    } else {
+        free(buffer);
+    }
+}
+
+/// Copies pbuf contents into a recycled slab buffer.
+/// Falls back to a heap allocation when the slab is exhausted or the packet exceeds the MTU.
+- (nullable NSData *)outboundDataFromPbufLocked:(struct pbuf *)pbuf length:(u16_t)len {
+    BOOL fromSlab = NO;
+    void *buffer = [self acquireOutboundBufferLocked:len fromSlab:&fromSlab];
+    if (!buffer) {
+        return nil;
+    }
+
+    u16_t ret = pbuf_copy_partial(pbuf, buffer, len, 0);
     if (ret != len) {
+        [self releaseOutboundBuffer:buffer fromSlab:fromSlab];
         [TFTunForgeLog
             warn:[NSString stringWithFormat:@"pbuf_copy_partial copied %u/%u bytes", ret, len]];
+        return nil;
+    }
+    return [self outboundDataWithBuffer:buffer length:len fromSlab:fromSlab];
+}
+
+/// Cuts a large-send super-segment into `mss` sized packets, one egress buffer each.
+- (void)segmentOutboundDataLocked:(struct pbuf *)pbuf mss:(u16_t)mss {
+    tf_gso_plan plan;
+    if (!tf_gso_plan_init(&plan, pbuf, mss)) {
+        [TFTunForgeLog warn:@"GSO: unsegmentable super-segment dropped"];
+        return;
+    }
+    _stats.egressSuperSegments++;
+
+    for (u16_t i = 0; i < plan.count; i++) {
+        u16_t payloadLength = tf_gso_payload_length(&plan, i);
+        u16_t len = (u16_t)(plan.hdrlen + payloadLength);
+
+        BOOL fromSlab = NO;
+        u8_t *buffer = [self acquireOutboundBufferLocked:len fromSlab:&fromSlab];
+        if (!buffer) {
+            // Send the packets built so far and stop: the peer's duplicate ACKs can then
+            // trigger fast retransmit instead of leaving recovery to an RTO.
+            _stats.egressAllocFailures += plan.count - i;
+            [TFTunForgeLog warn:[NSString stringWithFormat:@"GSO: out of memory, %u/%u dropped",
+                                                           (unsigned)(plan.count - i),
+                                                           (unsigned)plan.count]];
+            [self flushOutboundDataLocked];
+            return;
+        }
+
+        u16_t payloadSum = tf_gso_pbuf_copy_sum(
+            pbuf, tf_gso_payload_offset(&plan, i), payloadLength, buffer + plan.hdrlen);
+        tf_gso_build_header(&plan, i, buffer, payloadSum);
+        [self enqueueOutboundDataLocked:[self outboundDataWithBuffer:buffer
+                                                              length:len
+                                                            fromSlab:fromSlab]];
+    }
+}
+
+/// Zero-copy path: hold the pbuf until the upper layer completes the batch.
+/// Super-segments (`gsoMss` != 0) are cut at flush time: headers are built in the batch
+/// allocation, payload slices point into the pbuf.
+- (void)enqueueOutboundPbufLocked:(struct pbuf *)pbuf gsoMss:(u16_t)gsoMss {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    NSUInteger packets = 1;
+    if (gsoMss) {
+        tf_gso_plan plan;
+        if (!tf_gso_plan_init(&plan, pbuf, gsoMss)) {
+            [TFTunForgeLog warn:@"GSO: unsegmentable super-segment dropped"];
+            return;
+        }
+        packets = plan.count;
+        _stats.egressSuperSegments++;
+    }
+
+    if (self.pendingPbufCount == 0) {
+        self.pendingPbufFence = tf_egress_fence_open();
+    }
+    pbuf_ref(pbuf);
+    self.pendingPbufs[self.pendingPbufCount] = pbuf;
+    self.pendingPbufGsoMss[self.pendingPbufCount] = gsoMss;
+    self.pendingPbufCount += 1;
+    self.pendingPbufPacketCount += packets;
+    if (gsoMss) {
+        // One header slice per packet, and each pbuf boundary may split one payload.
+        self.pendingPbufHeaderCount += packets;
+        self.pendingPbufSliceCount += 2 * packets + pbuf_clen(pbuf);
+    } else {
+        self.pendingPbufSliceCount += pbuf_clen(pbuf);
+    }
+
+    // Packets, not pbufs: a super-segment counts for every packet cut from it. Each pbuf
+    // carries at least one packet, so this also bounds pendingPbufs.
+    if (self.pendingPbufPacketCount >= kTFEgressBatchMaxPackets) {
+        [self flushOutboundPbufsLocked];
+    } else if (self.pendingPbufCount == 1) {
+        TFPacketsTurnEnlist(self, TFPacketsTurnStageEgress);
+    }
+}
+
+- (void)flushOutboundLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    [self flushOutboundDataLocked];
+    [self flushOutboundPbufsLocked];
+}
+
+- (void)flushOutboundDataLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    NSUInteger count = self.pendingPackets.count;
+    if (count == 0)
+        return;
+
+    NSArray<NSData *> *packets = self.pendingPackets;
+    self.pendingPackets = [NSMutableArray arrayWithCapacity:count];
+
+    OutboundHandler outboundHandler = self.outboundHandler;
+    if (!outboundHandler)
         return;
+
+    NSMutableArray<NSNumber *> *families = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [families addObject:@(AF_INET)];
     }
+    outboundHandler(packets, families);
+}
+
+- (void)flushOutboundPbufsLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    NSUInteger count = self.pendingPbufCount;
+    if (count == 0)
+        return;
+
+    NSUInteger packetCount = self.pendingPbufPacketCount;
+    NSUInteger sliceCount = self.pendingPbufSliceCount;
+    NSUInteger headerCount = self.pendingPbufHeaderCount;
+    self.pendingPbufCount = 0;
+    self.pendingPbufPacketCount = 0;
+    self.pendingPbufSliceCount = 0;
+    self.pendingPbufHeaderCount = 0;
+
+    size_t size = sizeof(tf_egress_batch) + count * sizeof(struct pbuf *) +
+                  packetCount * sizeof(TFPacketDescriptor) + sliceCount * sizeof(TFBytesSlice) +
+                  headerCount * TF_GSO_HEADER_MAX;
+    tf_egress_batch *batch = (tf_egress_batch *)malloc(size);
+    if (!batch) {
+        // fallback: drop safely
+        _stats.egressAllocFailures += packetCount;
+        [TFTunForgeLog warn:@"Egress batch allocation failed; batch dropped"];
+        for (NSUInteger i = 0; i < count; i++) {
+            pbuf_free(self.pendingPbufs[i]);
+        }
+        tf_egress_fence_close(self.pendingPbufFence);
+        return;
+    }
+
+    batch->count = count;
+    batch->fence = self.pendingPbufFence;
+    batch->pbufs = (struct pbuf **)(batch + 1);
+    batch->packets = (TFPacketDescriptor *)(batch->pbufs + count);
+    batch->slices = (TFBytesSlice *)(batch->packets + packetCount);
+    batch->headers = (u8_t *)(batch->slices + sliceCount);
+    memcpy(batch->pbufs, self.pendingPbufs, count * sizeof(struct pbuf *));
+
+    TFPacketDescriptor *packet = batch->packets;
+    TFBytesSlice *slice = batch->slices;
+    u8_t *header = batch->headers;
+    for (NSUInteger i = 0; i < count; i++) {
+        struct pbuf *p = batch->pbufs[i];
+        u16_t gsoMss = self.pendingPbufGsoMss[i];
+
+        if (!gsoMss) {
+            packet->slices = slice;
+            packet->sliceCount = tf_egress_slices(p, 0, p->tot_len, slice);
+            packet->length = p->tot_len;
+            packet->family = AF_INET;
+            slice += packet->sliceCount;
+            packet++;
+            continue;
+        }
+
+        tf_gso_plan plan;
+        BOOL planned = tf_gso_plan_init(&plan, p, gsoMss);
+        LWIP_ASSERT("GSO plan changed since enqueue", planned);
+        if (!planned) {
+            continue;
+        }
+
+        for (u16_t j = 0; j < plan.count; j++) {
+            u16_t offset = tf_gso_payload_offset(&plan, j);
+            u16_t payloadLength = tf_gso_payload_length(&plan, j);
+            tf_gso_build_header(&plan, j, header, tf_gso_pbuf_sum(p, offset, payloadLength));
+
+            packet->slices = slice;
+            slice->bytes = header;
+            slice->length = plan.hdrlen;
+            packet->sliceCount = 1 + tf_egress_slices(p, offset, payloadLength, slice + 1);
+            packet->length = plan.hdrlen + payloadLength;
+            packet->family = AF_INET;
+            slice += packet->sliceCount;
+            header += TF_GSO_HEADER_MAX;
+            packet++;
+        }
+    }
+    batch->packetCount = (NSUInteger)(packet - batch->packets);
+
+    TFOutboundBytesBatchHandler outboundBytesHandler = self.outboundBytesHandler;
+    if (!outboundBytesHandler) {
+        tf_egress_batch_free(batch);
+        return;
+    }
+
+    outboundBytesHandler(batch->packets, batch->packetCount, ^{
+        [TFGlobalScheduler.shared packetsPerformAsync:^{
+            tf_egress_batch_free(batch);
+        }];
+    });
+}
 
-    NSArray *packets = @[ data ];
-    NSArray *families = @[ @(AF_INET) ];
-    self.outboundHandler(packets, families);
+#pragma mark - TFPacketsTurnObserver
+
+- (void)packetsTurnWillEnd {
+    [self flushOutboundLocked];
 }
 
 #pragma mark - setup once
@@ -266,6 +946,138 @@ static TFIPStack *get_stack_from_arg(void *arg) {
     return (TFIPStack *)ref.object;
 }
 
+static inline BOOL tf_ip4_is_fragment(const void *bytes, u16_t len) {
+    if (len < IP_HLEN)
+        return NO;
+
+    const struct ip_hdr *iphdr = (const struct ip_hdr *)bytes;
+    return IPH_V(iphdr) == 4 && (IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) != 0;
+}
+
+static tf_admission_class tf_admission_classify(const uint8_t *bytes,
+                                                u16_t len,
+                                                tf_admission_segment *segment) {
+    if (len < IP_HLEN || IPH_V((const struct ip_hdr *)bytes) != 4) {
+        return TF_ADMISSION_OTHER;
+    }
+
+    const struct ip_hdr *iphdr = (const struct ip_hdr *)bytes;
+    u16_t iphlen = IPH_HL_BYTES(iphdr);
+    u16_t totlen = MIN(lwip_ntohs(IPH_LEN(iphdr)), len);
+    if (IPH_PROTO(iphdr) != IP_PROTO_TCP || iphlen < IP_HLEN ||
+        totlen < iphlen + TCP_HLEN || tf_ip4_is_fragment(bytes, len)) {
+        return TF_ADMISSION_OTHER;
+    }
+
+    const struct tcp_hdr *tcphdr = (const struct tcp_hdr *)(bytes + iphlen);
+    u16_t tcphlen = TCPH_HDRLEN_BYTES(tcphdr);
+    if (tcphlen < TCP_HLEN || totlen < iphlen + tcphlen) {
+        return TF_ADMISSION_OTHER;
+    }
+
+    u8_t flags = TCPH_FLAGS(tcphdr);
+    if ((flags & (TCP_SYN | TCP_ACK)) == TCP_SYN) {
+        return TF_ADMISSION_SYN;
+    }
+
+    u16_t payloadLength = (u16_t)(totlen - iphlen - tcphlen);
+    if (payloadLength == 0 || (flags & (TCP_FIN | TCP_RST))) {
+        return TF_ADMISSION_CONTROL;
+    }
+
+    segment->src = (ip_addr_t)IPADDR4_INIT(iphdr->src.addr);
+    segment->dst = (ip_addr_t)IPADDR4_INIT(iphdr->dest.addr);
+    segment->sport = lwip_ntohs(tcphdr->src);
+    segment->dport = lwip_ntohs(tcphdr->dest);
+    segment->payloadLength = payloadLength;
+    return TF_ADMISSION_DATA;
+}
+
+static double tf_admission_pool_usage(void) {
+    const struct stats_mem *pool = lwip_stats.memp[MEMP_PBUF_POOL];
+    if (!pool || pool->avail == 0) {
+        return 0;
+    }
+    return (double)pool->used / (double)pool->avail;
+}
+
+static double tf_admission_heap_usage(void) {
+    if (lwip_stats.mem.avail == 0) {
+        return 0;
+    }
+    return (double)lwip_stats.mem.used / (double)lwip_stats.mem.avail;
+}
+
+static void tf_ingress_ref_pbuf_free(struct pbuf *p) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_ingress_ref_pbuf *ref = (tf_ingress_ref_pbuf *)p;
+    id owner = CFBridgingRelease(ref->owner);
+    ref->owner = NULL;
+    LWIP_MEMPOOL_FREE(TF_INGRESS_REF_PBUF, ref);
+
+    if (![owner isKindOfClass:[NSData class]]) {
+        ((TFPacketReleaseHandler)owner)();
+    }
+}
+
+static struct pbuf *tf_ingress_pbuf_wrap(const void *bytes, u16_t len, id owner) {
+    tf_ingress_ref_pbuf *ref = (tf_ingress_ref_pbuf *)LWIP_MEMPOOL_ALLOC(TF_INGRESS_REF_PBUF);
+    if (!ref) {
+        return NULL;
+    }
+
+    ref->custom.custom_free_function = tf_ingress_ref_pbuf_free;
+    struct pbuf *p =
+        pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &ref->custom, (void *)bytes, len);
+    if (!p) {
+        LWIP_MEMPOOL_FREE(TF_INGRESS_REF_PBUF, ref);
+        return NULL;
+    }
+
+    ref->owner = CFBridgingRetain(owner);
+    return p;
+}
+
+static struct pbuf *tf_gro_alloc(void *ctx, const void *bytes, u16_t len, void *owner) {
+    TFIPStack *stack = (__bridge TFIPStack *)ctx;
+    return [stack ingressPbufLocked:bytes length:len owner:(__bridge id)owner handedOff:NULL];
+}
+
+static void tf_gro_input(void *ctx, struct pbuf *p) {
+    TFIPStack *stack = (__bridge TFIPStack *)ctx;
+    [stack netifInputLocked:p];
+}
+
+/// Describes `len` bytes of the chain starting at `offset` as slices; returns the slice count.
+static NSUInteger tf_egress_slices(struct pbuf *p, u16_t offset, u16_t len, TFBytesSlice *slices) {
+    NSUInteger n = 0;
+    for (struct pbuf *q = p; q && len > 0; q = q->next) {
+        if (offset >= q->len) {
+            offset = (u16_t)(offset - q->len);
+            continue;
+        }
+        u16_t chunk = (u16_t)LWIP_MIN(len, q->len - offset);
+        slices[n].bytes = (const uint8_t *)q->payload + offset;
+        slices[n].length = chunk;
+        n++;
+        len = (u16_t)(len - chunk);
+        offset = 0;
+    }
+    return n;
+}
+
+static void tf_egress_batch_free(tf_egress_batch *batch) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    for (NSUInteger i = 0; i < batch->count; i++) {
+        pbuf_free(batch->pbufs[i]);
+    }
+    tf_egress_fence fence = batch->fence;
+    free(batch);
+    tf_egress_fence_close(fence);
+}
+
 #pragma mark - lwip bridge (lwIP -> ObjC)
 
 static err_t tunforge_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr) {
@@ -332,6 +1144,10 @@ static err_t tunforge_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
         return ERR_ABRT;
     }
 
+    if (stack.largeSendEnabled) {
+        tcp_tunforge_set_gso(newpcb, 1);
+    }
+
     TFTCPConnection *connection = [[TFTCPConnection alloc] initWithTCPPcb:newpcb];
     if (!connection) {
         [TFTunForgeLog warn:@"TCP accept: connection init failed"];
@@ -339,6 +1155,16 @@ static err_t tunforge_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
         return ERR_ABRT;
     }
 
+    if (stack.receiveWindowAutotuningEnabled) {
+        tf_rcv_wnd_set_budget(stack.receiveWindowBudget);
+        connection.receiveWindowAutotuningEnabled = YES;
+    }
+
+    if (stack.sendBufferAutotuningEnabled) {
+        tf_snd_buf_set_budget(stack.sendBufferBudget);
+        connection.sendBufferAutotuningEnabled = YES;
+    }
+
     id<TFIPStackDelegate> delegate = stack.delegate;
     if (!delegate || ![delegate respondsToSelector:@selector(didAcceptNewTCPConnection:handler:)]) {
         tcp_abort(newpcb);
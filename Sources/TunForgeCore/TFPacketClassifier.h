@@ -0,0 +1,23 @@
+//
+//  TFPacketClassifier.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TFIPStack.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Header pre-classifier run on raw TUN bytes before any pbuf is allocated.
+///
+/// Only IPv4 TCP reaches lwIP (built with LWIP_UDP 0 / LWIP_ICMP 0 / LWIP_IPV6 0);
+/// everything else is rejected here for free.
+///
+/// Validates the IPv4 version, IHL and total length the same way ip4_input() does, so a
+/// packet classified TCP is not dropped by lwIP for header reasons.
+TFPacketClass tf_packet_classify(const void *bytes, NSUInteger length);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,50 @@
+//
+//  TFPacketClassifier.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFPacketClassifier.h"
+
+#import "lwip/prot/ip.h"
+#import "lwip/prot/ip4.h"
+
+TFPacketClass tf_packet_classify(const void *bytes, NSUInteger length) {
+    if (!bytes || length == 0) {
+        return TFPacketClassMalformed;
+    }
+
+    const u8_t *raw = (const u8_t *)bytes;
+    switch (IP_HDR_GET_VERSION(raw)) {
+    case 4:
+        break;
+    case 6:
+        return TFPacketClassIPv6;
+    default:
+        return TFPacketClassMalformed;
+    }
+
+    if (length < IP_HLEN || length > UINT16_MAX) {
+        return TFPacketClassMalformed;
+    }
+
+    const struct ip_hdr *iphdr = (const struct ip_hdr *)bytes;
+    u16_t iphlen = IPH_HL_BYTES(iphdr);
+    u16_t totlen = lwip_ntohs(IPH_LEN(iphdr));
+    if (iphlen < IP_HLEN || iphlen > length || totlen < iphlen || totlen > length) {
+        return TFPacketClassMalformed;
+    }
+
+    switch (IPH_PROTO(iphdr)) {
+    case IP_PROTO_TCP:
+        return TFPacketClassTCP;
+    case IP_PROTO_UDP:
+    case IP_PROTO_UDPLITE:
+        return TFPacketClassUDP;
+    case IP_PROTO_ICMP:
+        return TFPacketClassICMP;
+    default:
+        return TFPacketClassOther;
+    }
+}
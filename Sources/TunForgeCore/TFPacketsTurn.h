@@ -0,0 +1,47 @@
+//
+//  TFPacketsTurn.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A packetsQueue "turn" is one unit of lwIP work: one input batch, one timer tick,
+/// or one block of API calls submitted to packetsQueue.
+///
+/// Work that is cheaper in bulk (egress packets, notifications, window updates) is
+/// enlisted here and flushed once when the turn ends.
+///
+/// Threading:
+/// - Everything here MUST be used on packetsQueue.
+typedef NS_ENUM(NSUInteger, TFPacketsTurnStage) {
+    /// Per-connection flushes. May produce egress packets.
+    TFPacketsTurnStageConnections = 0,
+    /// Stack egress flush. Runs after all connection flushes.
+    TFPacketsTurnStageEgress,
+    TFPacketsTurnStageCount
+};
+
+@protocol TFPacketsTurnObserver <NSObject>
+
+/// Called once per enlistment, on packetsQueue, when the current turn ends.
+- (void)packetsTurnWillEnd;
+
+@end
+
+/// Opens an explicit turn (nestable).
+FOUNDATION_EXPORT void TFPacketsTurnBegin(void);
+
+/// Closes an explicit turn; closing the outermost one drains all enlisted observers.
+FOUNDATION_EXPORT void TFPacketsTurnEnd(void);
+
+/// Enlists `observer` (retained until drained) for the end of the current turn.
+/// Enlisting twice in one turn is a no-op.
+/// Outside an explicit turn, the end of the turn is the next packetsQueue hop.
+FOUNDATION_EXPORT void TFPacketsTurnEnlist(id<TFPacketsTurnObserver> observer,
+                                           TFPacketsTurnStage stage);
+
+NS_ASSUME_NONNULL_END
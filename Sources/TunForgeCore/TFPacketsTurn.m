@@ -0,0 +1,75 @@
+//
+//  TFPacketsTurn.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFPacketsTurn.h"
+#import "TFQueueHelpers.h"
+
+// packetsQueue-owned state.
+static NSUInteger tf_turn_depth;
+static BOOL tf_turn_drain_scheduled;
+static NSMutableOrderedSet<id<TFPacketsTurnObserver>> *tf_turn_pending[TFPacketsTurnStageCount];
+
+static void tf_turn_drain(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    // Keep the turn open while draining so re-enlisted observers land in this drain.
+    tf_turn_depth++;
+
+    for (;;) {
+        NSArray<id<TFPacketsTurnObserver>> *observers = nil;
+        for (NSUInteger stage = 0; stage < TFPacketsTurnStageCount; stage++) {
+            if (tf_turn_pending[stage].count > 0) {
+                observers = tf_turn_pending[stage].array;
+                [tf_turn_pending[stage] removeAllObjects];
+                break;
+            }
+        }
+        if (!observers)
+            break;
+
+        for (id<TFPacketsTurnObserver> observer in observers) {
+            [observer packetsTurnWillEnd];
+        }
+    }
+
+    tf_turn_depth--;
+}
+
+void TFPacketsTurnBegin(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    tf_turn_depth++;
+}
+
+void TFPacketsTurnEnd(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    NSCAssert(tf_turn_depth > 0, @"TFPacketsTurnEnd without TFPacketsTurnBegin");
+
+    if (--tf_turn_depth > 0)
+        return;
+
+    tf_turn_drain();
+}
+
+void TFPacketsTurnEnlist(id<TFPacketsTurnObserver> observer, TFPacketsTurnStage stage) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    NSCParameterAssert(stage < TFPacketsTurnStageCount);
+
+    if (!tf_turn_pending[stage]) {
+        tf_turn_pending[stage] = [NSMutableOrderedSet orderedSet];
+    }
+    [tf_turn_pending[stage] addObject:observer];
+
+    if (tf_turn_depth > 0 || tf_turn_drain_scheduled)
+        return;
+
+    // Implicit turn: the caller's packetsQueue block is the turn.
+    tf_turn_drain_scheduled = YES;
+    tf_packets_defer(^{
+        tf_turn_drain_scheduled = NO;
+        tf_turn_drain();
+    });
+}
@@ -6,6 +6,7 @@
 //
 
 #import "TFQueueHelpers.h"
+#import "TFGlobalScheduler.h"
 #import "TFTunForgeLog.h"
 
 void TFBindQueueSpecific(dispatch_queue_t queue, const void *key, void *value) {
@@ -49,3 +50,7 @@ void TFAssertOnPACKETSQueue(const char *function, const char *file, int line) {
               function);
 #endif
 }
+
+void tf_packets_defer(dispatch_block_t block) {
+    dispatch_async(TFGlobalScheduler.shared.packetsQueue, block);
+}
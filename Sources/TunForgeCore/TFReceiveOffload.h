@@ -0,0 +1,75 @@
+//
+//  TFReceiveOffload.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "lwip/pbuf.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// GRO-style receive coalescing of in-order TCP segments within one input batch.
+///
+/// Consecutive segments of the same flow (same 4-tuple, contiguous seq, identical ack /
+/// window / options, flags ACK[+PSH] only) are merged into one IPv4 packet backed by a pbuf
+/// chain: the first segment's headers followed by payload-only pbufs. IP total length and
+/// header checksum are rewritten; the TCP checksum is derived incrementally from the
+/// original segment checksums (payloads are never summed again), so a corrupt segment
+/// still makes lwIP drop the merged packet.
+///
+/// A flow is flushed on any non-mergeable segment of that flow, after a PSH segment, at the
+/// u16 length cap, and at `tf_gro_flush` (batch end).
+///
+/// Threading:
+/// - MUST be used on packetsQueue.
+
+/// Maximum flows coalesced concurrently within one batch.
+#define TF_GRO_MAX_FLOWS 8
+
+typedef struct {
+    /// Builds a pbuf over `bytes` (zero-copy when `owner` is non-NULL, else copied).
+    struct pbuf *_Nullable (*alloc)(void *ctx, const void *bytes, u16_t len, void *_Nullable owner);
+    /// Feeds a complete packet to the netif; takes ownership of `p`.
+    void (*input)(void *ctx, struct pbuf *p);
+    void *ctx;
+} tf_gro_ops;
+
+typedef struct {
+    struct pbuf *_Nullable head; // NULL: slot free
+    struct pbuf *_Nullable tail;
+    u32_t src;                   // network order
+    u32_t dst;
+    u16_t sport;
+    u16_t dport;
+    u32_t nextSeq;               // host order
+    u32_t ack;                   // network order
+    u16_t wnd;                   // network order
+    u16_t tcphlen;
+    u32_t payloadLength;
+    u32_t dataSum;               // folded one's complement sum of all payloads
+    u16_t segments;
+} tf_gro_flow;
+
+typedef struct {
+    tf_gro_ops ops;
+    tf_gro_flow flows[TF_GRO_MAX_FLOWS];
+    u8_t evict;
+    /// Segments absorbed into a preceding segment (monotonic).
+    uint64_t coalesced;
+} tf_gro;
+
+void tf_gro_init(tf_gro *gro, const tf_gro_ops *ops);
+
+/// Offers a validated IPv4 TCP packet.
+/// Returns YES if the packet was taken (held or merged), NO if the caller must input it
+/// itself; pending segments of the same flow have then already been flushed, so per-flow
+/// order is preserved.
+BOOL tf_gro_offer(tf_gro *gro, const void *bytes, u16_t len, void *_Nullable owner);
+
+/// Feeds every pending flow to the netif.
+void tf_gro_flush(tf_gro *gro);
+
+NS_ASSUME_NONNULL_END
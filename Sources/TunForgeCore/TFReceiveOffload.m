@@ -0,0 +1,301 @@
+//
+//  TFReceiveOffload.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFReceiveOffload.h"
+
+#import "lwip/def.h"
+#import "lwip/inet_chksum.h"
+#import "lwip/prot/ip.h"
+#import "lwip/prot/ip4.h"
+#import "lwip/prot/tcp.h"
+
+/// Raw flag byte values a segment may carry to be coalesced.
+#define TF_GRO_FLAGS_ALLOWED (TCP_ACK | TCP_PSH)
+
+typedef struct {
+    u32_t src;
+    u32_t dst;
+    u16_t sport;
+    u16_t dport;
+} tf_gro_key;
+
+typedef struct {
+    const u8_t *bytes;
+    const struct tcp_hdr *tcphdr;
+    u16_t tcphlen;
+    u16_t payloadLength;
+    u32_t seq;
+    BOOL psh;
+} tf_gro_segment;
+
+#pragma mark - One's complement helpers
+
+static inline u32_t tf_gro_fold(u32_t acc) {
+    acc = FOLD_U32T(acc);
+    return FOLD_U32T(acc);
+}
+
+static inline u16_t tf_gro_sub(u16_t a, u16_t b) {
+    return (u16_t)tf_gro_fold((u32_t)a + (u16_t)~b);
+}
+
+/// Folded, non-inverted sum of `len` bytes.
+static inline u16_t tf_gro_sum(const void *bytes, u16_t len) {
+    return (u16_t)~inet_chksum(bytes, len);
+}
+
+static u16_t tf_gro_pseudo_sum(u32_t src, u32_t dst, u16_t tcplen) {
+    u32_t acc = (src & 0xffffU) + (src >> 16) + (dst & 0xffffU) + (dst >> 16);
+    acc += lwip_htons((u16_t)IP_PROTO_TCP);
+    acc += lwip_htons(tcplen);
+    return (u16_t)tf_gro_fold(acc);
+}
+
+/// Payload sum of a segment whose checksum is valid: 0xffff - pseudo - header.
+static u16_t tf_gro_payload_sum(const tf_gro_key *key, const tf_gro_segment *seg) {
+    u16_t pseudo =
+        tf_gro_pseudo_sum(key->src, key->dst, (u16_t)(seg->tcphlen + seg->payloadLength));
+    return tf_gro_sub(tf_gro_sub(0xffffU, pseudo), tf_gro_sum(seg->tcphdr, seg->tcphlen));
+}
+
+#pragma mark - Parsing
+
+/// 4-tuple of a TCP packet (already validated by the pre-classifier).
+static BOOL tf_gro_key_of(const void *bytes, u16_t len, tf_gro_key *key) {
+    const struct ip_hdr *iphdr = (const struct ip_hdr *)bytes;
+    u16_t iphlen = IPH_HL_BYTES(iphdr);
+    if (len < iphlen + 4) {
+        return NO;
+    }
+
+    const struct tcp_hdr *tcphdr = (const struct tcp_hdr *)((const u8_t *)bytes + iphlen);
+    key->src = iphdr->src.addr;
+    key->dst = iphdr->dest.addr;
+    key->sport = tcphdr->src;
+    key->dport = tcphdr->dest;
+    return YES;
+}
+
+/// Returns YES if the packet is a coalescing candidate.
+static BOOL tf_gro_parse(const void *bytes, u16_t len, tf_gro_segment *seg) {
+    if (len <= IP_HLEN + TCP_HLEN) {
+        return NO;
+    }
+
+    // No IP options, no fragments, no link padding, valid header checksum: the merged
+    // packet reuses the first header and recomputes its checksum.
+    const struct ip_hdr *iphdr = (const struct ip_hdr *)bytes;
+    if (IPH_V(iphdr) != 4 || IPH_HL(iphdr) != 5 || IPH_PROTO(iphdr) != IP_PROTO_TCP ||
+        lwip_ntohs(IPH_LEN(iphdr)) != len ||
+        (IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) != 0 ||
+        inet_chksum(iphdr, IP_HLEN) != 0) {
+        return NO;
+    }
+
+    const struct tcp_hdr *tcphdr = (const struct tcp_hdr *)((const u8_t *)bytes + IP_HLEN);
+    u16_t tcphlen = TCPH_HDRLEN_BYTES(tcphdr);
+    if (tcphlen < TCP_HLEN || IP_HLEN + tcphlen >= len) {
+        return NO;
+    }
+
+    // Raw flag byte, so ECE / CWR also end coalescing.
+    u8_t flags = ((const u8_t *)tcphdr)[13];
+    if (!(flags & TCP_ACK) || (flags & ~TF_GRO_FLAGS_ALLOWED) != 0) {
+        return NO;
+    }
+
+    seg->bytes = (const u8_t *)bytes;
+    seg->tcphdr = tcphdr;
+    seg->tcphlen = tcphlen;
+    seg->payloadLength = (u16_t)(len - IP_HLEN - tcphlen);
+    seg->seq = lwip_ntohl(tcphdr->seqno);
+    seg->psh = (flags & TCP_PSH) != 0;
+    return YES;
+}
+
+#pragma mark - Flows
+
+static tf_gro_flow *tf_gro_find(tf_gro *gro, const tf_gro_key *key) {
+    for (NSUInteger i = 0; i < TF_GRO_MAX_FLOWS; i++) {
+        tf_gro_flow *flow = &gro->flows[i];
+        if (flow->head && flow->sport == key->sport && flow->dport == key->dport &&
+            flow->src == key->src && flow->dst == key->dst) {
+            return flow;
+        }
+    }
+    return NULL;
+}
+
+static void tf_gro_flush_flow(tf_gro *gro, tf_gro_flow *flow) {
+    struct pbuf *head = flow->head;
+    if (!head) {
+        return;
+    }
+
+    if (flow->segments > 1) {
+        u8_t *iphdr = (u8_t *)head->payload;
+        struct tcp_hdr *tcphdr = (struct tcp_hdr *)(iphdr + IP_HLEN);
+        u16_t tcplen = (u16_t)(flow->tcphlen + flow->payloadLength);
+        u16_t total = (u16_t)(IP_HLEN + tcplen);
+
+        IPH_LEN_SET((struct ip_hdr *)iphdr, lwip_htons(total));
+        IPH_CHKSUM_SET((struct ip_hdr *)iphdr, 0);
+        IPH_CHKSUM_SET((struct ip_hdr *)iphdr, inet_chksum(iphdr, IP_HLEN));
+
+        tcphdr->chksum = 0;
+        u32_t acc = tf_gro_sum(tcphdr, flow->tcphlen);
+        acc += tf_gro_pseudo_sum(flow->src, flow->dst, tcplen);
+        acc += flow->dataSum;
+        tcphdr->chksum = (u16_t)~tf_gro_fold(acc);
+
+        // Payload pbufs were linked raw; restore the tot_len invariant once.
+        u16_t remaining = total;
+        for (struct pbuf *q = head; q != NULL; q = q->next) {
+            q->tot_len = remaining;
+            remaining = (u16_t)(remaining - q->len);
+        }
+    }
+
+    memset(flow, 0, sizeof(*flow));
+    gro->ops.input(gro->ops.ctx, head);
+}
+
+static tf_gro_flow *tf_gro_claim(tf_gro *gro) {
+    for (NSUInteger i = 0; i < TF_GRO_MAX_FLOWS; i++) {
+        if (!gro->flows[i].head) {
+            return &gro->flows[i];
+        }
+    }
+
+    tf_gro_flow *flow = &gro->flows[gro->evict];
+    gro->evict = (u8_t)((gro->evict + 1) % TF_GRO_MAX_FLOWS);
+    tf_gro_flush_flow(gro, flow);
+    return flow;
+}
+
+static BOOL tf_gro_can_append(const tf_gro_flow *flow, const tf_gro_segment *seg) {
+    const u8_t *iphdr = (const u8_t *)flow->head->payload;
+    const struct tcp_hdr *tcphdr = (const struct tcp_hdr *)(iphdr + IP_HLEN);
+
+    if (seg->seq != flow->nextSeq || seg->tcphdr->ackno != flow->ack ||
+        seg->tcphdr->wnd != flow->wnd || seg->tcphlen != flow->tcphlen ||
+        IPH_TOS((const struct ip_hdr *)seg->bytes) != IPH_TOS((const struct ip_hdr *)iphdr)) {
+        return NO;
+    }
+    if ((u32_t)IP_HLEN + flow->tcphlen + flow->payloadLength + seg->payloadLength > 0xffffU) {
+        return NO;
+    }
+    // Options (e.g. timestamps) must match byte for byte: only the first header survives.
+    return memcmp((const u8_t *)tcphdr + TCP_HLEN,
+                  (const u8_t *)seg->tcphdr + TCP_HLEN,
+                  flow->tcphlen - TCP_HLEN) == 0;
+}
+
+static inline struct pbuf *tf_gro_last(struct pbuf *p) {
+    while (p->next) {
+        p = p->next;
+    }
+    return p;
+}
+
+static BOOL tf_gro_append(tf_gro *gro,
+                          tf_gro_flow *flow,
+                          const tf_gro_key *key,
+                          const tf_gro_segment *seg,
+                          void *owner) {
+    struct pbuf *p = gro->ops.alloc(
+        gro->ops.ctx, seg->bytes + IP_HLEN + seg->tcphlen, seg->payloadLength, owner);
+    if (!p) {
+        return NO;
+    }
+
+    u16_t sum = tf_gro_payload_sum(key, seg);
+    if (flow->payloadLength & 1) {
+        sum = (u16_t)SWAP_BYTES_IN_WORD(sum);
+    }
+    flow->dataSum = tf_gro_fold(flow->dataSum + sum);
+
+    flow->tail->next = p;
+    flow->tail = tf_gro_last(p);
+    flow->payloadLength += seg->payloadLength;
+    flow->nextSeq = seg->seq + seg->payloadLength;
+    flow->segments++;
+    gro->coalesced++;
+
+    if (seg->psh) {
+        TCPH_SET_FLAG((struct tcp_hdr *)((u8_t *)flow->head->payload + IP_HLEN), TCP_PSH);
+    }
+    return YES;
+}
+
+#pragma mark - API
+
+void tf_gro_init(tf_gro *gro, const tf_gro_ops *ops) {
+    memset(gro, 0, sizeof(*gro));
+    gro->ops = *ops;
+}
+
+BOOL tf_gro_offer(tf_gro *gro, const void *bytes, u16_t len, void *owner) {
+    tf_gro_key key;
+    if (!tf_gro_key_of(bytes, len, &key)) {
+        return NO;
+    }
+
+    tf_gro_segment seg;
+    BOOL mergeable = tf_gro_parse(bytes, len, &seg);
+    tf_gro_flow *flow = tf_gro_find(gro, &key);
+
+    if (flow) {
+        if (mergeable && tf_gro_can_append(flow, &seg) &&
+            tf_gro_append(gro, flow, &key, &seg, owner)) {
+            if (seg.psh) {
+                tf_gro_flush_flow(gro, flow);
+            }
+            return YES;
+        }
+        tf_gro_flush_flow(gro, flow);
+    }
+
+    // PSH ends a run: nothing may follow it, so there is nothing to hold it for.
+    if (!mergeable || seg.psh) {
+        return NO;
+    }
+
+    u16_t hdrlen = (u16_t)(IP_HLEN + seg.tcphlen);
+    struct pbuf *p = gro->ops.alloc(gro->ops.ctx, bytes, len, owner);
+    if (!p) {
+        return NO;
+    }
+    if (p->len < hdrlen) {
+        // Headers must be contiguous to be rewritten; feed it through as is.
+        gro->ops.input(gro->ops.ctx, p);
+        return YES;
+    }
+
+    flow = tf_gro_claim(gro);
+    flow->head = p;
+    flow->tail = tf_gro_last(p);
+    flow->src = key.src;
+    flow->dst = key.dst;
+    flow->sport = key.sport;
+    flow->dport = key.dport;
+    flow->nextSeq = seg.seq + seg.payloadLength;
+    flow->ack = seg.tcphdr->ackno;
+    flow->wnd = seg.tcphdr->wnd;
+    flow->tcphlen = seg.tcphlen;
+    flow->payloadLength = seg.payloadLength;
+    flow->dataSum = tf_gro_payload_sum(&key, &seg);
+    flow->segments = 1;
+    return YES;
+}
+
+void tf_gro_flush(tf_gro *gro) {
+    for (NSUInteger i = 0; i < TF_GRO_MAX_FLOWS; i++) {
+        tf_gro_flush_flow(gro, &gro->flows[i]);
+    }
+    gro->evict = 0;
+}
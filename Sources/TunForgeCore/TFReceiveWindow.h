@@ -0,0 +1,51 @@
+//
+//  TFReceiveWindow.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "lwip/tcp.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Receive-window autotuning of one pcb, driven by how fast the upper layer drains it.
+///
+/// Once per epoch the window (tcp_tunforge_set_rcv_wnd_max) is:
+/// - doubled when the sender ran it nearly dry while the consumer kept up
+///   (little delivered-but-unacknowledged data left);
+/// - halved when the consumer falls behind (half the window waiting on acknowledgement),
+///   or when the flow no longer uses the room it grew, down to TCP_WND.
+///
+/// Window above TCP_WND is charged to a budget shared by all tuned pcbs, so only the
+/// flows that need it get large windows.
+///
+/// Threading:
+/// - Everything here MUST be used on packetsQueue.
+typedef struct {
+    uint32_t wndMax;       // window size applied, 0 while not tuning
+    uint32_t wndBase;      // the pcb's TCP_WND; only the window above it is charged
+    uint32_t epochStartMs; // sys_now()
+    uint32_t epochBytes;   // received this epoch
+    BOOL epochLimited;     // the sender ran the window low this epoch
+} tf_rcv_wnd_tuner;
+
+/// Bytes of window above TCP_WND all tuned pcbs may hold together.
+void tf_rcv_wnd_set_budget(NSUInteger budget);
+
+/// Starts tuning `pcb` from its current window.
+void tf_rcv_wnd_start(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb);
+
+/// Stops tuning and returns the budget; `pcb` (if still valid) goes back to TCP_WND.
+void tf_rcv_wnd_stop(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *_Nullable pcb);
+
+/// Call from tcp_recv after accepting `len` bytes.
+void tf_rcv_wnd_note_received(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb, NSUInteger len);
+
+/// Re-evaluates the window once the epoch is over.
+/// `backlog` is the data delivered upward but not yet acknowledged.
+void tf_rcv_wnd_update(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb, uint64_t backlog);
+
+NS_ASSUME_NONNULL_END
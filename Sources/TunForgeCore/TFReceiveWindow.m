@@ -0,0 +1,120 @@
+//
+//  TFReceiveWindow.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFReceiveWindow.h"
+#import "TFQueueHelpers.h"
+
+#include "lwip/sys.h"
+
+static const uint32_t kTFRcvWndEpochMs = 200;
+static const uint32_t kTFRcvWndMin = 4 * TCP_MSS;
+
+// packetsQueue only.
+static NSUInteger tf_rcv_wnd_budget;
+static NSUInteger tf_rcv_wnd_charged;
+
+static inline NSUInteger tf_rcv_wnd_excess(uint32_t wnd, uint32_t base) {
+    return wnd > base ? wnd - base : 0;
+}
+
+/// Applies `target` as far as lwIP and the budget allow, moving the charge along.
+static void tf_rcv_wnd_apply(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb, uint32_t target) {
+    const uint32_t base = tuner->wndBase;
+    const NSUInteger charged = tf_rcv_wnd_excess(tuner->wndMax, base);
+    const NSUInteger others = tf_rcv_wnd_charged - charged;
+
+    target = MIN(target, (uint32_t)TCP_WND_CEIL(pcb));
+    if (target > tuner->wndMax) {
+        NSUInteger room = tf_rcv_wnd_budget > others ? tf_rcv_wnd_budget - others : 0;
+        target = (uint32_t)MIN((NSUInteger)target, base + room);
+        if (target <= tuner->wndMax)
+            return;
+    }
+
+    // A shrink completes as held data is consumed: track the size the window is heading to.
+    uint32_t applied = tcp_tunforge_set_rcv_wnd_max(pcb, (tcpwnd_size_t)target) -
+                       pcb->tunforge_rcv_wnd_debt;
+    tf_rcv_wnd_charged = others + tf_rcv_wnd_excess(applied, base);
+    tuner->wndMax = applied;
+}
+
+void tf_rcv_wnd_set_budget(NSUInteger budget) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_rcv_wnd_budget = budget;
+}
+
+void tf_rcv_wnd_start(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (tuner->wndMax)
+        return;
+
+    tuner->wndMax = TCP_WND_MAX(pcb);
+    tuner->wndBase = TCP_WND_DEFAULT(pcb);
+    tuner->epochStartMs = sys_now();
+    tuner->epochBytes = 0;
+    tuner->epochLimited = NO;
+    tf_rcv_wnd_charged += tf_rcv_wnd_excess(tuner->wndMax, tuner->wndBase);
+}
+
+void tf_rcv_wnd_stop(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tuner->wndMax)
+        return;
+
+    if (pcb) {
+        tf_rcv_wnd_apply(tuner, pcb, 0);
+    }
+    tf_rcv_wnd_charged -= tf_rcv_wnd_excess(tuner->wndMax, tuner->wndBase);
+    tuner->wndMax = 0;
+}
+
+void tf_rcv_wnd_note_received(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb, NSUInteger len) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tuner->wndMax)
+        return;
+
+    tuner->epochBytes = (uint32_t)MIN((NSUInteger)tuner->epochBytes + len, (NSUInteger)UINT32_MAX);
+    if (pcb->rcv_wnd < tuner->wndMax / 4) {
+        tuner->epochLimited = YES;
+    }
+}
+
+void tf_rcv_wnd_update(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb, uint64_t backlog) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tuner->wndMax)
+        return;
+
+    u32_t now = sys_now();
+    if (now - tuner->epochStartMs < kTFRcvWndEpochMs)
+        return;
+
+    const uint32_t wnd = tuner->wndMax;
+    const uint32_t base = tuner->wndBase;
+    uint32_t target = wnd;
+    if (backlog >= wnd / 2) {
+        // Consumer falls behind: a larger window would only buffer more.
+        target = MAX(wnd / 2, kTFRcvWndMin);
+    } else if (tuner->epochLimited && backlog <= wnd / 4) {
+        target = wnd * 2;
+    } else if (wnd > base && tuner->epochBytes < wnd / 4) {
+        // Grown room left unused: give it back to the budget.
+        target = MAX(wnd / 2, base);
+    }
+
+    if (target != wnd) {
+        tf_rcv_wnd_apply(tuner, pcb, target);
+    }
+
+    tuner->epochStartMs = now;
+    tuner->epochBytes = 0;
+    tuner->epochLimited = NO;
+}
@@ -0,0 +1,36 @@
+//
+//  TFReleaseList.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Lock-free multi-producer / single-consumer list of intrusive nodes.
+///
+/// Producers push from any thread; the consumer detaches the whole list at once, so there
+/// is no ABA hazard. Used to hand work back to packetsQueue without one GCD block per item.
+///
+/// Threading:
+/// - tf_release_list_push: any thread.
+/// - tf_release_list_take: one consumer (packetsQueue).
+typedef struct tf_release_node {
+    struct tf_release_node *_Nullable next;
+} tf_release_node;
+
+typedef struct {
+    _Atomic(tf_release_node *) head;
+} tf_release_list;
+
+/// Returns YES when the list was empty, i.e. the caller must schedule a drain.
+BOOL tf_release_list_push(tf_release_list *list, tf_release_node *node);
+
+/// Detaches every pushed node, oldest first.
+tf_release_node *_Nullable tf_release_list_take(tf_release_list *list);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,31 @@
+//
+//  TFReleaseList.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFReleaseList.h"
+
+BOOL tf_release_list_push(tf_release_list *list, tf_release_node *node) {
+    tf_release_node *old = atomic_load_explicit(&list->head, memory_order_relaxed);
+    do {
+        node->next = old;
+    } while (!atomic_compare_exchange_weak_explicit(
+        &list->head, &old, node, memory_order_release, memory_order_relaxed));
+    return old == NULL;
+}
+
+tf_release_node *tf_release_list_take(tf_release_list *list) {
+    tf_release_node *node = atomic_exchange_explicit(&list->head, NULL, memory_order_acquire);
+
+    // Pushed newest first; reverse to release in completion order.
+    tf_release_node *ordered = NULL;
+    while (node) {
+        tf_release_node *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+    return ordered;
+}
@@ -0,0 +1,69 @@
+//
+//  TFSegmentationOffload.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "lwip/pbuf.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// GSO-style software segmentation of lwIP large-send super-segments.
+///
+/// A super-segment is one IPv4/TCP packet of up to ~64 KB produced for a pcb with
+/// TF_TUNFORGE_GSO set; it carries no TCP checksum. It is cut into packets of `mss` bytes
+/// (options included) from a header template: per packet only length, IP id, sequence
+/// number and FIN/PSH (last packet only) change, so both checksums are finished
+/// incrementally from precomputed template sums plus the packet's payload sum.
+///
+/// Threading:
+/// - MUST be used on packetsQueue.
+
+/// Upper bound of IPv4 + TCP header bytes of a super-segment (no IP options, 40 B TCP options).
+#define TF_GSO_HEADER_MAX 80
+
+typedef struct {
+    const struct pbuf *p;
+    const u8_t *header; // template: IP + TCP header at the start of p
+    u16_t iphlen;
+    u16_t hdrlen;       // IP + TCP header bytes
+    u16_t payloadLength;
+    u16_t unit;         // payload bytes per packet
+    u16_t count;        // packets
+    u32_t seq;          // host order
+    u16_t ipid;         // host order
+    u32_t ipBaseSum;    // IP header sum without length / id / checksum
+    u32_t tcpBaseSum;   // TCP header + pseudo header sum without seq / flags / length / checksum
+} tf_gso_plan;
+
+/// Parses a super-segment. `mss` is the wire MSS (TCP options included).
+/// Returns NO if `p` is not a segmentable IPv4/TCP packet.
+BOOL tf_gso_plan_init(tf_gso_plan *plan, const struct pbuf *p, u16_t mss);
+
+static inline u16_t tf_gso_payload_offset(const tf_gso_plan *plan, u16_t index) {
+    return (u16_t)(plan->hdrlen + index * plan->unit);
+}
+
+static inline u16_t tf_gso_payload_length(const tf_gso_plan *plan, u16_t index) {
+    u32_t start = (u32_t)index * plan->unit;
+    u32_t left = plan->payloadLength - start;
+    return (u16_t)(left < plan->unit ? left : plan->unit);
+}
+
+/// Folded one's complement sum of `len` bytes of the chain starting at `offset`.
+u16_t tf_gso_pbuf_sum(const struct pbuf *p, u16_t offset, u16_t len);
+
+/// pbuf_copy_partial() into `dst` fused with tf_gso_pbuf_sum(): one pass over the payload.
+u16_t tf_gso_pbuf_copy_sum(const struct pbuf *p, u16_t offset, u16_t len, u8_t *dst);
+
+/// Folded one's complement sum of contiguous bytes.
+u16_t tf_gso_sum(const void *bytes, u16_t len);
+
+/// Writes the `plan->hdrlen` header bytes of packet `index` into `out`.
+/// `payloadSum` is the folded sum of the packet's payload.
+void tf_gso_build_header(const tf_gso_plan *plan, u16_t index, u8_t *out, u16_t payloadSum);
+
+NS_ASSUME_NONNULL_END
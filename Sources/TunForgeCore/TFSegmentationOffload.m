@@ -0,0 +1,154 @@
+//
+//  TFSegmentationOffload.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFSegmentationOffload.h"
+
+#import "lwip/def.h"
+#import "lwip/inet_chksum.h"
+#import "lwip/prot/ip.h"
+#import "lwip/prot/ip4.h"
+#import "lwip/prot/tcp.h"
+
+/// Byte offsets of the per-packet fields.
+#define TF_GSO_IP_LEN      2
+#define TF_GSO_IP_ID       4
+#define TF_GSO_IP_CHKSUM   10
+#define TF_GSO_TCP_SEQ     4
+#define TF_GSO_TCP_FLAGS   12 // 16-bit word: data offset + flags
+#define TF_GSO_TCP_CHKSUM  16
+
+static inline u32_t tf_gso_fold(u32_t acc) {
+    acc = FOLD_U32T(acc);
+    return FOLD_U32T(acc);
+}
+
+static inline u16_t tf_gso_word(const u8_t *bytes, u16_t offset) {
+    u16_t word;
+    memcpy(&word, bytes + offset, sizeof(word));
+    return word;
+}
+
+u16_t tf_gso_sum(const void *bytes, u16_t len) {
+    return (u16_t)~inet_chksum(bytes, len);
+}
+
+/// Sums (and with `dst`, copies in the same pass) `len` bytes of the chain from `offset`.
+static u16_t tf_gso_pbuf_sum_copy(const struct pbuf *p, u16_t offset, u16_t len, u8_t *dst) {
+    while (p && offset >= p->len) {
+        offset = (u16_t)(offset - p->len);
+        p = p->next;
+    }
+
+    u32_t acc = 0;
+    BOOL odd = NO;
+    for (; p && len > 0; p = p->next) {
+        u16_t n = (u16_t)LWIP_MIN(len, p->len - offset);
+        const u8_t *src = (const u8_t *)p->payload + offset;
+        u16_t sum;
+        if (dst) {
+            sum = LWIP_CHKSUM_COPY(dst, src, n);
+            dst += n;
+        } else {
+            sum = tf_gso_sum(src, n);
+        }
+        acc += odd ? (u16_t)SWAP_BYTES_IN_WORD(sum) : sum;
+        odd ^= (n & 1);
+        len = (u16_t)(len - n);
+        offset = 0;
+    }
+    return (u16_t)tf_gso_fold(acc);
+}
+
+u16_t tf_gso_pbuf_sum(const struct pbuf *p, u16_t offset, u16_t len) {
+    return tf_gso_pbuf_sum_copy(p, offset, len, NULL);
+}
+
+u16_t tf_gso_pbuf_copy_sum(const struct pbuf *p, u16_t offset, u16_t len, u8_t *dst) {
+    return tf_gso_pbuf_sum_copy(p, offset, len, dst);
+}
+
+BOOL tf_gso_plan_init(tf_gso_plan *plan, const struct pbuf *p, u16_t mss) {
+    if (!p || p->len < IP_HLEN + TCP_HLEN) {
+        return NO;
+    }
+
+    const u8_t *header = (const u8_t *)p->payload;
+    const struct ip_hdr *iphdr = (const struct ip_hdr *)header;
+    u16_t iphlen = IPH_HL_BYTES(iphdr);
+    if (IPH_V(iphdr) != 4 || IPH_PROTO(iphdr) != IP_PROTO_TCP || iphlen < IP_HLEN ||
+        p->len < iphlen + TCP_HLEN) {
+        return NO;
+    }
+
+    const struct tcp_hdr *tcphdr = (const struct tcp_hdr *)(header + iphlen);
+    u16_t tcphlen = TCPH_HDRLEN_BYTES(tcphdr);
+    u16_t hdrlen = (u16_t)(iphlen + tcphlen);
+    if (tcphlen < TCP_HLEN || hdrlen > TF_GSO_HEADER_MAX || p->len < hdrlen ||
+        p->tot_len <= hdrlen || mss <= tcphlen - TCP_HLEN) {
+        return NO;
+    }
+
+    plan->p = p;
+    plan->header = header;
+    plan->iphlen = iphlen;
+    plan->hdrlen = hdrlen;
+    plan->payloadLength = (u16_t)(p->tot_len - hdrlen);
+    plan->unit = (u16_t)(mss - (tcphlen - TCP_HLEN));
+    plan->count = (u16_t)((plan->payloadLength + plan->unit - 1) / plan->unit);
+    plan->seq = lwip_ntohl(tcphdr->seqno);
+    plan->ipid = lwip_ntohs(IPH_ID(iphdr));
+
+    // Template sums with the per-packet fields zeroed.
+    u8_t scratch[TF_GSO_HEADER_MAX];
+    memcpy(scratch, header, hdrlen);
+    memset(scratch + TF_GSO_IP_LEN, 0, 2);
+    memset(scratch + TF_GSO_IP_ID, 0, 2);
+    memset(scratch + TF_GSO_IP_CHKSUM, 0, 2);
+    plan->ipBaseSum = tf_gso_sum(scratch, iphlen);
+
+    u8_t *tcp = scratch + iphlen;
+    memset(tcp + TF_GSO_TCP_SEQ, 0, 4);
+    memset(tcp + TF_GSO_TCP_FLAGS, 0, 2);
+    memset(tcp + TF_GSO_TCP_CHKSUM, 0, 2);
+    u32_t acc = tf_gso_sum(tcp, tcphlen);
+    u32_t src = iphdr->src.addr;
+    u32_t dst = iphdr->dest.addr;
+    acc += (src & 0xffffU) + (src >> 16) + (dst & 0xffffU) + (dst >> 16);
+    acc += lwip_htons((u16_t)IP_PROTO_TCP);
+    plan->tcpBaseSum = tf_gso_fold(acc);
+    return YES;
+}
+
+void tf_gso_build_header(const tf_gso_plan *plan, u16_t index, u8_t *out, u16_t payloadSum) {
+    u16_t payloadLength = tf_gso_payload_length(plan, index);
+    BOOL last = index + 1 == plan->count;
+    memcpy(out, plan->header, plan->hdrlen);
+
+    // IPv4
+    u16_t ipLength = lwip_htons((u16_t)(plan->hdrlen + payloadLength));
+    u16_t ipid = lwip_htons((u16_t)(plan->ipid + index));
+    memcpy(out + TF_GSO_IP_LEN, &ipLength, 2);
+    memcpy(out + TF_GSO_IP_ID, &ipid, 2);
+    u16_t ipChksum = (u16_t)~tf_gso_fold(plan->ipBaseSum + ipLength + ipid);
+    memcpy(out + TF_GSO_IP_CHKSUM, &ipChksum, 2);
+
+    // TCP
+    u8_t *tcp = out + plan->iphlen;
+    u32_t seq = lwip_htonl(plan->seq + (u32_t)index * plan->unit);
+    memcpy(tcp + TF_GSO_TCP_SEQ, &seq, 4);
+    if (!last) {
+        tcp[TF_GSO_TCP_FLAGS + 1] &= (u8_t)~(TCP_FIN | TCP_PSH);
+    }
+
+    u16_t tcpLength = lwip_htons((u16_t)(plan->hdrlen - plan->iphlen + payloadLength));
+    u32_t acc = plan->tcpBaseSum + (seq & 0xffffU) + (seq >> 16);
+    acc += tf_gso_word(tcp, TF_GSO_TCP_FLAGS);
+    acc += tcpLength;
+    acc += payloadSum;
+    u16_t tcpChksum = (u16_t)~tf_gso_fold(acc);
+    memcpy(tcp + TF_GSO_TCP_CHKSUM, &tcpChksum, 2);
+}
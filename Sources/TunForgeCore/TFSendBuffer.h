@@ -0,0 +1,51 @@
+//
+//  TFSendBuffer.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "lwip/tcp.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Send-buffer autotuning of one pcb, driven by its ACK rate and RTT.
+///
+/// A tuned pcb starts small (kTFSndBufInitial) instead of at TCP_SND_BUF. Once per epoch
+/// its limit (tcp_tunforge_set_snd_buf_max) follows twice the measured bandwidth-delay
+/// product: it grows (at least doubling) while writes find the buffer full, and shrinks by
+/// at most half when they don't. TCP_SND_BUF is the ceiling.
+///
+/// Buffer above the initial size is charged to a budget shared by all tuned pcbs, so a
+/// burst of connections cannot all claim TCP_SND_BUF.
+///
+/// Threading:
+/// - Everything here MUST be used on packetsQueue.
+typedef struct {
+    uint32_t bufMax;       // limit applied, 0 while not tuning
+    uint32_t epochStartMs; // sys_now()
+    uint32_t epochAcked;   // bytes ACKed this epoch
+    BOOL epochLimited;     // the buffer ran (nearly) full this epoch
+} tf_snd_buf_tuner;
+
+/// Bytes of send buffer above the initial size all tuned pcbs may hold together.
+void tf_snd_buf_set_budget(NSUInteger budget);
+
+/// Starts tuning `pcb` at the initial size.
+void tf_snd_buf_start(tf_snd_buf_tuner *tuner, struct tcp_pcb *pcb);
+
+/// Stops tuning and returns the budget; `pcb` (if still valid) goes back to TCP_SND_BUF.
+void tf_snd_buf_stop(tf_snd_buf_tuner *tuner, struct tcp_pcb *_Nullable pcb);
+
+/// Call from tcp_sent. `backlogged`: writes are waiting for buffer space (send queue).
+void tf_snd_buf_note_acked(tf_snd_buf_tuner *tuner,
+                           struct tcp_pcb *pcb,
+                           NSUInteger len,
+                           BOOL backlogged);
+
+/// Re-sizes the buffer once the epoch is over.
+void tf_snd_buf_update(tf_snd_buf_tuner *tuner, struct tcp_pcb *pcb);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,123 @@
+//
+//  TFSendBuffer.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFSendBuffer.h"
+#import "TFQueueHelpers.h"
+
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/sys.h"
+
+static const uint32_t kTFSndBufEpochMs = 200;
+static const uint32_t kTFSndBufInitial =
+    (TCP_SND_BUF / 8 > 4 * TCP_MSS) ? TCP_SND_BUF / 8 : 4 * TCP_MSS;
+
+// lwIP measures RTT in TCP_SLOW_INTERVAL ticks; a TUN peer usually reads as 0.
+static const uint32_t kTFSndBufMinRttMs = 20;
+
+// packetsQueue only.
+static NSUInteger tf_snd_buf_budget;
+static NSUInteger tf_snd_buf_charged;
+
+static inline NSUInteger tf_snd_buf_excess(uint32_t size) {
+    return size > kTFSndBufInitial ? size - kTFSndBufInitial : 0;
+}
+
+/// Applies `target` as far as the budget allows, moving the charge along.
+static void tf_snd_buf_apply(tf_snd_buf_tuner *tuner, struct tcp_pcb *pcb, uint32_t target) {
+    const NSUInteger others = tf_snd_buf_charged - tf_snd_buf_excess(tuner->bufMax);
+
+    target = MIN(target, (uint32_t)TCP_SND_BUF);
+    if (target > tuner->bufMax) {
+        NSUInteger room = tf_snd_buf_budget > others ? tf_snd_buf_budget - others : 0;
+        target = (uint32_t)MIN((NSUInteger)target, kTFSndBufInitial + room);
+        if (target <= tuner->bufMax)
+            return;
+    }
+
+    uint32_t applied = tcp_tunforge_set_snd_buf_max(pcb, (tcpwnd_size_t)target);
+    tf_snd_buf_charged = others + tf_snd_buf_excess(applied);
+    tuner->bufMax = applied;
+}
+
+void tf_snd_buf_set_budget(NSUInteger budget) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_snd_buf_budget = budget;
+}
+
+void tf_snd_buf_start(tf_snd_buf_tuner *tuner, struct tcp_pcb *pcb) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (tuner->bufMax)
+        return;
+
+    tuner->bufMax = tcp_tunforge_set_snd_buf_max(pcb, (tcpwnd_size_t)kTFSndBufInitial);
+    tuner->epochStartMs = sys_now();
+    tuner->epochAcked = 0;
+    tuner->epochLimited = NO;
+}
+
+void tf_snd_buf_stop(tf_snd_buf_tuner *tuner, struct tcp_pcb *pcb) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tuner->bufMax)
+        return;
+
+    tf_snd_buf_charged -= tf_snd_buf_excess(tuner->bufMax);
+    tuner->bufMax = 0;
+    if (pcb) {
+        tcp_tunforge_set_snd_buf_max(pcb, 0);
+    }
+}
+
+void tf_snd_buf_note_acked(tf_snd_buf_tuner *tuner,
+                           struct tcp_pcb *pcb,
+                           NSUInteger len,
+                           BOOL backlogged) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tuner->bufMax)
+        return;
+
+    tuner->epochAcked = (uint32_t)MIN((NSUInteger)tuner->epochAcked + len, (NSUInteger)UINT32_MAX);
+    // snd_buf before this ACK's credit
+    if (backlogged || pcb->snd_buf < tuner->bufMax / 4 + len) {
+        tuner->epochLimited = YES;
+    }
+}
+
+void tf_snd_buf_update(tf_snd_buf_tuner *tuner, struct tcp_pcb *pcb) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!tuner->bufMax)
+        return;
+
+    u32_t now = sys_now();
+    u32_t elapsed = now - tuner->epochStartMs;
+    if (elapsed < kTFSndBufEpochMs)
+        return;
+
+    const uint32_t size = tuner->bufMax;
+    uint64_t rttMs = MAX((uint64_t)(pcb->sa >> 3) * TCP_SLOW_INTERVAL, kTFSndBufMinRttMs);
+    uint64_t bdp = (uint64_t)tuner->epochAcked * rttMs / elapsed;
+    uint64_t target = MAX(2 * bdp, kTFSndBufInitial);
+    if (tuner->epochLimited) {
+        // Writes waited on the buffer while the peer kept ACKing: probe upward.
+        target = MAX(target, 2 * (uint64_t)size);
+    } else {
+        target = MIN(MAX(target, size / 2), size);
+    }
+
+    target = MIN(target, (uint64_t)TCP_SND_BUF);
+    if (target != size) {
+        tf_snd_buf_apply(tuner, pcb, (uint32_t)target);
+    }
+
+    tuner->epochStartMs = now;
+    tuner->epochAcked = 0;
+    tuner->epochLimited = NO;
+}
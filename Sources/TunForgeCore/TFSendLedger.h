@@ -0,0 +1,45 @@
+//
+//  TFSendLedger.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TFTCPConnection.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Caller buffers that lwIP segments of one pcb reference without a copy
+/// (`writeBytesNoCopy:length:release:`), in send order.
+///
+/// Each entry is keyed by the sequence number just past its last byte; it is released once
+/// the peer has ACKed through that number, or when the pcb is destroyed. lwIP keeps
+/// unacked segments (and so their payload pointers) for retransmission until then.
+/// Releases go through tf_egress_fence_after(), since the zero-copy egress path may still
+/// read a freed segment.
+///
+/// Ownership contract:
+/// - One ledger per pcb, owned by its tcp_ext_arg slot (TUNFORGE_TCP_EXTARG_LEDGER_ID).
+///
+/// Threading:
+/// - Everything here MUST be used on packetsQueue.
+typedef struct tf_send_ledger tf_send_ledger;
+
+tf_send_ledger *_Nullable tf_send_ledger_create(void);
+
+/// Makes room for one tf_send_ledger_append(); call before handing the bytes to lwIP.
+/// Returns NO if out of memory.
+BOOL tf_send_ledger_reserve(tf_send_ledger *ledger);
+
+/// Appends `release` for bytes ending before `endSeq`. Needs a prior reserve.
+void tf_send_ledger_append(tf_send_ledger *ledger, uint32_t endSeq, TFTCPWriteReleaseHandler release);
+
+/// Releases every entry the cumulative ACK `lastack` covers.
+void tf_send_ledger_acknowledge(tf_send_ledger *ledger, uint32_t lastack);
+
+/// Releases every remaining entry and frees the ledger.
+void tf_send_ledger_destroy(tf_send_ledger *ledger);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,90 @@
+//
+//  TFSendLedger.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFSendLedger.h"
+#import "TFEgressFence.h"
+#import "TFQueueHelpers.h"
+
+typedef struct {
+    uint32_t endSeq;
+    void *release; // +1 TFTCPWriteReleaseHandler
+} tf_send_ledger_entry;
+
+/// Ring of entries, grown by doubling.
+struct tf_send_ledger {
+    tf_send_ledger_entry *entries;
+    NSUInteger capacity;
+    NSUInteger head;
+    NSUInteger count;
+};
+
+static const NSUInteger kTFSendLedgerInitialCapacity = 8;
+
+static void tf_send_ledger_release_head(tf_send_ledger *ledger) {
+    tf_send_ledger_entry *entry = &ledger->entries[ledger->head];
+    TFTCPWriteReleaseHandler release = (__bridge_transfer TFTCPWriteReleaseHandler)entry->release;
+    ledger->head = (ledger->head + 1) % ledger->capacity;
+    ledger->count--;
+
+    tf_egress_fence_after(release);
+}
+
+tf_send_ledger *tf_send_ledger_create(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    return calloc(1, sizeof(tf_send_ledger));
+}
+
+BOOL tf_send_ledger_reserve(tf_send_ledger *ledger) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (ledger->count == ledger->capacity) {
+        NSUInteger capacity = ledger->capacity ? 2 * ledger->capacity : kTFSendLedgerInitialCapacity;
+        tf_send_ledger_entry *entries = malloc(capacity * sizeof(tf_send_ledger_entry));
+        if (!entries)
+            return NO;
+
+        for (NSUInteger i = 0; i < ledger->count; i++) {
+            entries[i] = ledger->entries[(ledger->head + i) % ledger->capacity];
+        }
+        free(ledger->entries);
+        ledger->entries = entries;
+        ledger->capacity = capacity;
+        ledger->head = 0;
+    }
+    return YES;
+}
+
+void tf_send_ledger_append(tf_send_ledger *ledger, uint32_t endSeq, TFTCPWriteReleaseHandler release) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    NSCAssert(ledger->count < ledger->capacity, @"tf_send_ledger_append without reserve");
+
+    tf_send_ledger_entry *entry = &ledger->entries[(ledger->head + ledger->count) % ledger->capacity];
+    entry->endSeq = endSeq;
+    entry->release = (__bridge_retained void *)[release copy];
+    ledger->count++;
+}
+
+void tf_send_ledger_acknowledge(tf_send_ledger *ledger, uint32_t lastack) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    // Sequence-space comparison: lastack >= endSeq.
+    while (ledger->count > 0 &&
+           (int32_t)(lastack - ledger->entries[ledger->head].endSeq) >= 0) {
+        tf_send_ledger_release_head(ledger);
+    }
+}
+
+void tf_send_ledger_destroy(tf_send_ledger *ledger) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    while (ledger->count > 0) {
+        tf_send_ledger_release_head(ledger);
+    }
+    free(ledger->entries);
+    free(ledger);
+}
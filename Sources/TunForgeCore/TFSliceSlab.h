@@ -0,0 +1,50 @@
+//
+//  TFSliceSlab.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TFTCPConnection.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// TFBytesSlice arrays for zero-copy receive delivery (`onReadableBytes`).
+///
+/// Chains of up to kTFInlineSliceCount pbufs use the connection's inline buffer; longer
+/// chains, or deliveries overlapping one that still holds it, come from a global
+/// size-classed slab, then the heap.
+///
+/// Threading:
+/// - Acquire and counters MUST be used on packetsQueue.
+/// - Release is lock-free and may run on any thread.
+
+/// Slices held inline by every TFTCPConnection; covers the common 1-4 pbuf chain.
+#define kTFInlineSliceCount 4
+
+typedef NS_ENUM(uint8_t, TFSliceSource) {
+    TFSliceSourceInline = 0,
+    TFSliceSourceSlab,
+    TFSliceSourceHeap,
+};
+
+typedef struct {
+    uint64_t inlineHits;
+    uint64_t slabHits;
+    uint64_t heapFallbacks; // no size class fits, or the class is exhausted
+} tf_slice_stats;
+
+/// Slab (else heap) array for `count` slices; NULL only if the heap allocation fails.
+TFBytesSlice *_Nullable tf_slices_acquire(NSUInteger count, TFSliceSource *source);
+
+/// Returns an array from tf_slices_acquire(); inline arrays are ignored.
+void tf_slices_release(TFBytesSlice *slices, NSUInteger count, TFSliceSource source);
+
+/// Counts a delivery served from a connection's inline buffer.
+void tf_slices_note_inline(void);
+
+tf_slice_stats tf_slices_get_stats(void);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,75 @@
+//
+//  TFSliceSlab.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFSliceSlab.h"
+#import "TFBufferSlab.h"
+
+#define TF_SLICE_CLASS_COUNT 3
+
+/// Slices per array and arrays per class; GRO-merged chains reach ~45 pbufs.
+static const NSUInteger kTFSliceClassSlices[TF_SLICE_CLASS_COUNT] = {8, 16, 64};
+static const NSUInteger kTFSliceClassCapacity[TF_SLICE_CLASS_COUNT] = {256, 128, 64};
+
+static tf_buffer_slab *tf_slice_slabs[TF_SLICE_CLASS_COUNT];
+static tf_slice_stats tf_slice_counters;
+
+static void tf_slices_setup(void) {
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        for (NSUInteger i = 0; i < TF_SLICE_CLASS_COUNT; i++) {
+            tf_slice_slabs[i] = tf_buffer_slab_create(
+                kTFSliceClassCapacity[i], kTFSliceClassSlices[i] * sizeof(TFBytesSlice));
+        }
+    });
+}
+
+static inline NSInteger tf_slice_class(NSUInteger count) {
+    for (NSInteger i = 0; i < TF_SLICE_CLASS_COUNT; i++) {
+        if (count <= kTFSliceClassSlices[i])
+            return i;
+    }
+    return -1;
+}
+
+TFBytesSlice *tf_slices_acquire(NSUInteger count, TFSliceSource *source) {
+    tf_slices_setup();
+
+    NSInteger cls = tf_slice_class(count);
+    if (cls >= 0 && tf_slice_slabs[cls]) {
+        TFBytesSlice *slices = tf_buffer_slab_acquire(tf_slice_slabs[cls]);
+        if (slices) {
+            tf_slice_counters.slabHits++;
+            *source = TFSliceSourceSlab;
+            return slices;
+        }
+    }
+
+    tf_slice_counters.heapFallbacks++;
+    *source = TFSliceSourceHeap;
+    return (TFBytesSlice *)malloc(sizeof(TFBytesSlice) * count);
+}
+
+void tf_slices_release(TFBytesSlice *slices, NSUInteger count, TFSliceSource source) {
+    switch (source) {
+    case TFSliceSourceInline:
+        break;
+    case TFSliceSourceSlab:
+        tf_buffer_slab_release(tf_slice_slabs[tf_slice_class(count)], slices);
+        break;
+    case TFSliceSourceHeap:
+        free(slices);
+        break;
+    }
+}
+
+void tf_slices_note_inline(void) {
+    tf_slice_counters.inlineHits++;
+}
+
+tf_slice_stats tf_slices_get_stats(void) {
+    return tf_slice_counters;
+}
@@ -24,8 +24,14 @@
 
 #import "TFTCPConnection.h"
 #import "TFGlobalScheduler.h"
-#import "TFObjectRef.h"
+#import "TFHandleTable.h"
+#import "TFPacketsTurn.h"
 #import "TFQueueHelpers.h"
+#import "TFReceiveWindow.h"
+#import "TFReleaseList.h"
+#import "TFSendBuffer.h"
+#import "TFSendLedger.h"
+#import "TFSliceSlab.h"
 #import "TFTCPConnectionInfo.h"
 #import "TFTunForgeLog.h"
 #import "TFWeakifyStrongify.h"
@@ -78,6 +84,61 @@ static inline BOOL tf_tcp_read_ready(struct tcp_pcb *pcb) {
     return pcb->rcv_wnd >= lowWaterMark;
 }
 
+/// State of one vectored write: regions are fed in order until the send buffer is full.
+typedef struct {
+    struct tcp_pcb *pcb;
+    NSUInteger total;   // bytes offered by the caller
+    NSUInteger written; // bytes accepted by tcp_write
+    NSUInteger budget;  // tcp_sndbuf left for this call
+    NSUInteger room;    // send queue space left for this call
+    NSUInteger queued;  // bytes copied into the send queue
+    BOOL whole;         // all-or-nothing: accepted only if every byte fits
+    BOOL more;          // corked: no chunk ends the burst
+    err_t err;
+} tf_tcp_vector_write;
+
+/// Queues as much of `bytes` as the budget allows, in u16_t chunks. Every chunk but the
+/// last one of the call (all of them when corked) carry TCP_WRITE_FLAG_MORE so lwIP neither
+/// sets PSH nor splits early. Returns NO once the budget is spent or tcp_write fails.
+static BOOL tf_tcp_write_region(tf_tcp_vector_write *w, const uint8_t *bytes, NSUInteger length) {
+    while (length > 0) {
+        if (w->budget == 0)
+            return NO;
+
+        u16_t chunk = (u16_t)MIN(MIN(length, w->budget), (NSUInteger)UINT16_MAX);
+        BOOL last = (w->written + chunk == w->total) || (chunk == w->budget);
+        u8_t flags = TCP_WRITE_FLAG_COPY | ((last && !w->more) ? 0 : TCP_WRITE_FLAG_MORE);
+
+        err_t err = tcp_write(w->pcb, bytes, chunk, flags);
+        if (err != ERR_OK) {
+            w->err = err;
+            return NO;
+        }
+
+        w->written += chunk;
+        w->budget -= chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+    return YES;
+}
+
+#pragma mark - Receive release
+
+/// One finished zero-copy delivery handed back to packetsQueue, or (`p == NULL`) a
+/// connection's pending async credit. See tf_rx_release_drain().
+typedef struct {
+    tf_release_node node; // MUST stay first
+    void *conn;           // +1 TFTCPConnection until drained
+    struct pbuf *p;
+    TFBytesSlice *slices;
+    NSUInteger sliceCount;
+    TFSliceSource source;
+} tf_rx_release;
+
+static tf_rx_release *tf_rx_release_alloc(void);
+static void tf_rx_release_push(tf_rx_release *release);
+
 #pragma mark - LwIP raw declarations
 
 static err_t tf_tcp_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
@@ -90,6 +151,10 @@ static void tf_tcp_extarg_destroy(u8_t ID, void *arg);
 static const struct tcp_ext_arg_callbacks tf_tcp_extarg_cbs;
 #endif
 
+#if LWIP_TCP_PCB_NUM_EXT_ARGS > TUNFORGE_TCP_EXTARG_LEDGER_ID
+static const struct tcp_ext_arg_callbacks tf_tcp_ledger_cbs;
+#endif
+
 #pragma mark - TFTCPConnection()
 
 typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
@@ -99,10 +164,9 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     TFTCPConnectionClosed
 };
 
-@interface TFTCPConnection ()
+@interface TFTCPConnection () <TFPacketsTurnObserver>
 
 @property (nonatomic, assign) struct tcp_pcb *pcb;
-@property (nonatomic, strong) TFObjectRef *pcbRef;
 
 @property (nonatomic, assign) u32_t newStateStartMs;
 
@@ -119,6 +183,15 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
 @property (nonatomic, assign) BOOL didNotifyTerminated;
 
 @property (nonatomic, assign) BOOL pendingClose;
+@property (nonatomic, assign) BOOL pendingShutdown; // shutdownWrite waiting for the send queue
+
+@property (nonatomic, assign) NSUInteger sendQueueLength;
+
+@property (nonatomic, assign) BOOL corked;
+
+// Send-side notifications, coalesced per packetsQueue turn.
+@property (nonatomic, assign) NSUInteger unreportedSentBytes;
+@property (nonatomic, assign) BOOL notifiedWritable; // last value sent to onWritableChanged
 
 // Lifecycle receive gate.
 // MUST NOT be toggled for inflight backpressure.
@@ -126,9 +199,38 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
 
 @property (nonatomic, assign) uint64_t inflightAckBytes;
 
+// refused_data may be taken again: redeliver at turn end instead of on tcp_fasttmr.
+@property (nonatomic, assign) BOOL redeliverRefused;
+
 @end
 
-@implementation TFTCPConnection
+@implementation TFTCPConnection {
+    // What lwIP holds in callback_arg / ext-arg instead of a pointer to this connection.
+    tf_handle _handle;
+
+    // Slice array of the in-flight zero-copy delivery, if it fits (see TFSliceSlab.h).
+    TFBytesSlice _inlineSlices[kTFInlineSliceCount];
+    BOOL _inlineSlicesBusy;
+
+    // Chains received this turn, flushed as one onReadableBytes delivery (packetsQueue only).
+    struct pbuf *_pendingRx;
+
+    // Bytes accepted by a write that lwIP had no room for yet (sendQueueHighWatermark > 0).
+    dispatch_data_t _sendQueue;
+
+    // -acknowledgeDeliveredBytesAsync: credit; `_creditRelease` is queued on the 0 -> n edge.
+    _Atomic(NSUInteger) _pendingCredit;
+    tf_rx_release _creditRelease;
+
+    // Credit acknowledged this turn, handed to lwIP once when the turn ends.
+    NSUInteger _turnCredit;
+
+    // Receive-window autotuning (receiveWindowAutotuningEnabled).
+    tf_rcv_wnd_tuner _rcvWndTuner;
+
+    // Send-buffer autotuning (sendBufferAutotuningEnabled).
+    tf_snd_buf_tuner _sndBufTuner;
+}
 
 - (instancetype)init {
     NSAssert(NO, @"Use initWithTCPPcb:");
@@ -165,34 +267,38 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
                                                      dstIP:remoteIP
                                                    dstPort:remotePort];
 
-        [self setupPcb];
+        if (![self setupPcb])
+            return nil;
     }
     return self;
 }
 
 #pragma mark - Setup
 
-- (void)setupPcb {
+- (BOOL)setupPcb {
     TF_ASSERT_ON_PACKETS_QUEUE();
     struct tcp_pcb *pcb = self.pcb;
     if (!pcb)
-        return;
+        return NO;
 
-    self.pcbRef = [[TFObjectRef alloc] initWithObject:self];
+    // The table keeps this connection alive until terminateLocked frees the handle.
+    _handle = tf_handle_alloc(self);
+    if (!_handle)
+        return NO;
 
-    tcp_arg(pcb, (__bridge void *)self.pcbRef);
+    tcp_arg(pcb, (void *)_handle);
     tcp_recv(pcb, tf_tcp_recv);
     tcp_sent(pcb, tf_tcp_sent);
     tcp_poll(pcb, tf_tcp_poll, 2);
     tcp_err(pcb, tf_tcp_err);
 
 #if LWIP_TCP_PCB_NUM_EXT_ARGS
-    // tcp_ext_arg_set() establishes a pcb-lifetime ownership.
-    // `arg` will be destroyed exactly once by lwIP, regardless of early callback detachment.
-    void *arg = [self.pcbRef retainedVoidPointer];
+    // The destroy callback runs exactly once, when lwIP frees the pcb, regardless of early
+    // callback detachment; by then the handle may be stale.
     tcp_ext_arg_set_callbacks(pcb, TUNFORGE_TCP_EXTARG_ID, &tf_tcp_extarg_cbs);
-    tcp_ext_arg_set(pcb, TUNFORGE_TCP_EXTARG_ID, arg);
+    tcp_ext_arg_set(pcb, TUNFORGE_TCP_EXTARG_ID, (void *)_handle);
 #endif
+    return YES;
 }
 
 #pragma mark - Public
@@ -211,6 +317,7 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
 
     [TFTunForgeLog info:@"TCP connection established"];
     [self notifyActiveOnceLocked];
+    [self scheduleRefusedRedeliveryLocked];
 }
 
 - (void)setInboundDeliveryEnabled:(BOOL)enabled {
@@ -221,6 +328,7 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     }
 
     _recvEnabled = enabled;
+    [self scheduleRefusedRedeliveryLocked];
 }
 
 - (void)acknowledgeDeliveredBytes:(NSUInteger)bytes {
@@ -236,16 +344,25 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
         return;
 
     NSUInteger credit = MIN(bytes, self.inflightAckBytes);
-    NSUInteger remaining = credit;
 
-    // Safety: lwIP tcp_recved takes u16_t
-    while (remaining > 0) {
-        u16_t chunk = (u16_t)MIN(remaining, (NSUInteger)UINT16_MAX);
-        tcp_recved(self.pcb, chunk);
-        remaining -= chunk;
-    }
+    // Window opens once per turn (applyTurnCreditLocked): one window-update decision
+    // however many acknowledgements arrive.
+    _turnCredit += credit;
+    TFPacketsTurnEnlist(self, TFPacketsTurnStageConnections);
 
     [self updateInflightAckBytes:-(NSInteger)credit];
+    [self scheduleRefusedRedeliveryLocked];
+}
+
+- (void)acknowledgeDeliveredBytesAsync:(NSUInteger)bytes {
+    if (bytes == 0)
+        return;
+
+    if (atomic_fetch_add_explicit(&_pendingCredit, bytes, memory_order_acq_rel) != 0)
+        return; // already queued; the drain picks up the sum
+
+    _creditRelease.conn = (__bridge_retained void *)self;
+    tf_rx_release_push(&_creditRelease);
 }
 
 - (TFTCPWriteResult)writeBytes:(const void *)bytes length:(NSUInteger)length {
@@ -266,14 +383,22 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
         return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteOverflow};
     }
 
+    if (self.sendQueueHighWatermark > 0) {
+        TFBytesSlice slice = {.bytes = bytes, .length = length};
+        return [self writeSlicesLocked:&slice count:1 whole:YES];
+    }
+
     if (!self.alive || !self.pcb || self.state != TFTCPConnectionActive || self.writeFIN) {
         return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteClosed};
     }
 
-    err_t err = tcp_write(self.pcb, bytes, (u16_t)length, TCP_WRITE_FLAG_COPY);
+    u8_t flags = TCP_WRITE_FLAG_COPY | (self.corked ? TCP_WRITE_FLAG_MORE : 0);
+    err_t err = tcp_write(self.pcb, bytes, (u16_t)length, flags);
 
     if (err == ERR_OK) {
-        tcp_output(self.pcb);
+        if (!self.corked) {
+            tcp_output(self.pcb);
+        }
         [self updateWritableLocked:tf_tcp_write_ready(self.pcb)];
         return (TFTCPWriteResult){.written = length, .status = TFTCPWriteOK};
     }
@@ -288,6 +413,61 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteError};
 }
 
+- (TFTCPWriteResult)writeBytesNoCopy:(const void *)bytes
+                              length:(NSUInteger)length
+                             release:(TFTCPWriteReleaseHandler)release {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    // Contract: caller MUST ensure length <= UINT16_MAX, length > 0
+
+    if (!bytes || length == 0 || length > UINT16_MAX) {
+        // Programming error - caller violated the contract
+        [TFTunForgeLog error:@"writeBytesNoCopy length out of range; reject"];
+        NSAssert(bytes != NULL && length > 0 && length <= UINT16_MAX,
+                 @"writeBytesNoCopy length out of range");
+        return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteOverflow};
+    }
+
+#if LWIP_TCP_PCB_NUM_EXT_ARGS > TUNFORGE_TCP_EXTARG_LEDGER_ID
+    if (!self.alive || !self.pcb || self.state != TFTCPConnectionActive || self.writeFIN) {
+        return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteClosed};
+    }
+
+    // Queued bytes go first; lwIP would otherwise send these ahead of them.
+    tf_send_ledger *ledger = _sendQueue ? NULL : [self sendLedgerLocked];
+    if (!ledger || !tf_send_ledger_reserve(ledger)) {
+        return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteWouldBlock};
+    }
+
+    // No TCP_WRITE_FLAG_COPY: segments hold PBUF_ROM pointers into `bytes`.
+    err_t err = tcp_write(self.pcb, bytes, (u16_t)length, self.corked ? TCP_WRITE_FLAG_MORE : 0);
+
+    if (err == ERR_OK) {
+        tf_send_ledger_append(ledger, self.pcb->snd_lbb, release);
+        if (!self.corked) {
+            tcp_output(self.pcb);
+        }
+        [self refreshWritableLocked];
+        return (TFTCPWriteResult){.written = length, .status = TFTCPWriteOK};
+    }
+
+    if (err == ERR_MEM) {
+        [self updateWritableLocked:NO];
+        return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteWouldBlock};
+    }
+
+    // Other errors are fatal
+    [self abortLocked:TFTCPConnectionTerminationReasonAbort];
+    return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteError};
+#else
+    // No ext-arg slot to tie buffers to the pcb lifetime: copy.
+    TFTCPWriteResult result = [self writeBytes:bytes length:length];
+    if (result.status == TFTCPWriteOK) {
+        release();
+    }
+    return result;
+#endif
+}
+
 - (TFTCPWriteResult)writeData:(NSData *)data {
     TF_ASSERT_ON_PACKETS_QUEUE();
 
@@ -298,6 +478,180 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     return [self writeBytes:data.bytes length:data.length];
 }
 
+- (TFTCPWriteResult)writeSlices:(const TFBytesSlice *)slices count:(NSUInteger)count {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    return [self writeSlicesLocked:slices count:count whole:NO];
+}
+
+- (TFTCPWriteResult)writeSlicesLocked:(const TFBytesSlice *)slices
+                                count:(NSUInteger)count
+                                whole:(BOOL)whole {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_tcp_vector_write w = {.whole = whole};
+    for (NSUInteger i = 0; i < count; i++) {
+        w.total += slices[i].length;
+    }
+
+    TFTCPWriteResult result;
+    if ([self beginVectorWriteLocked:&w result:&result]) {
+        for (NSUInteger i = 0; i < count; i++) {
+            if (!tf_tcp_write_region(&w, slices[i].bytes, slices[i].length))
+                break;
+        }
+
+        // Copy what lwIP did not take into the send queue, in order.
+        NSUInteger skip = w.written;
+        BOOL queueable = w.err == ERR_OK || w.err == ERR_MEM;
+        for (NSUInteger i = 0; i < count && w.room > 0 && queueable; i++) {
+            if (skip >= slices[i].length) {
+                skip -= slices[i].length;
+                continue;
+            }
+            NSUInteger length = MIN(slices[i].length - skip, w.room);
+            dispatch_data_t piece = dispatch_data_create((const uint8_t *)slices[i].bytes + skip,
+                                                         length,
+                                                         NULL,
+                                                         DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+            [self appendSendQueueLocked:piece];
+            w.queued += length;
+            w.room -= length;
+            skip = 0;
+        }
+        result = [self finishVectorWriteLocked:&w];
+    }
+    return result;
+}
+
+- (TFTCPWriteResult)writeDispatchData:(dispatch_data_t)data {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    __block tf_tcp_vector_write w = {.total = dispatch_data_get_size(data)};
+
+    TFTCPWriteResult result;
+    if ([self beginVectorWriteLocked:&w result:&result]) {
+        dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset,
+                                        const void *buffer, size_t size) {
+            return tf_tcp_write_region(&w, buffer, size);
+        });
+
+        // The rest is queued by reference: dispatch_data is immutable.
+        BOOL queueable = w.err == ERR_OK || w.err == ERR_MEM;
+        if (w.room > 0 && queueable && w.written < w.total) {
+            NSUInteger length = MIN(w.total - w.written, w.room);
+            [self appendSendQueueLocked:dispatch_data_create_subrange(data, w.written, length)];
+            w.queued = length;
+        }
+        result = [self finishVectorWriteLocked:&w];
+    }
+    return result;
+}
+
+- (void)cork {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (self.corked || !self.pcb)
+        return;
+    self.corked = YES;
+    tcp_tunforge_set_cork(self.pcb, 1);
+}
+
+- (void)uncork {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.corked)
+        return;
+    self.corked = NO;
+
+    if (!self.pcb)
+        return;
+    tcp_tunforge_set_cork(self.pcb, 0);
+    tcp_output(self.pcb);
+}
+
+- (void)flush {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.alive || !self.pcb)
+        return;
+
+    // Sends the partial tail too; the cork holds again from the next write.
+    if (self.corked) {
+        tcp_tunforge_set_cork(self.pcb, 0);
+        tcp_output(self.pcb);
+        tcp_tunforge_set_cork(self.pcb, 1);
+        return;
+    }
+    tcp_output(self.pcb);
+}
+
+- (BOOL)nagleEnabled {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    return self.pcb ? !tcp_nagle_disabled(self.pcb) : NO;
+}
+
+- (void)setNagleEnabled:(BOOL)nagleEnabled {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.pcb)
+        return;
+
+    if (nagleEnabled) {
+        tcp_nagle_enable(self.pcb);
+    } else {
+        tcp_nagle_disable(self.pcb);
+    }
+}
+
+- (BOOL)receiveWindowAutotuningEnabled {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    return _rcvWndTuner.wndMax != 0;
+}
+
+- (void)setReceiveWindowAutotuningEnabled:(BOOL)receiveWindowAutotuningEnabled {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.alive || !self.pcb)
+        return;
+
+    if (receiveWindowAutotuningEnabled) {
+        tf_rcv_wnd_start(&_rcvWndTuner, self.pcb);
+    } else {
+        tf_rcv_wnd_stop(&_rcvWndTuner, self.pcb);
+    }
+}
+
+- (BOOL)sendBufferAutotuningEnabled {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    return _sndBufTuner.bufMax != 0;
+}
+
+- (void)setSendBufferAutotuningEnabled:(BOOL)sendBufferAutotuningEnabled {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.alive || !self.pcb)
+        return;
+
+    if (sendBufferAutotuningEnabled) {
+        tf_snd_buf_start(&_sndBufTuner, self.pcb);
+    } else {
+        tf_snd_buf_stop(&_sndBufTuner, self.pcb);
+    }
+}
+
+- (NSUInteger)sendBufferLimit {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.pcb)
+        return 0;
+
+    return self.pcb->tunforge_snd_buf_max ? self.pcb->tunforge_snd_buf_max : TCP_SND_BUF;
+}
+
 - (void)shutdownWrite {
     TF_ASSERT_ON_PACKETS_QUEUE();
 
@@ -310,11 +664,12 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     self.writeFIN = YES;
 
     [TFTunForgeLog info:@"TCP shutdownWrite"];
-#if LWIP_TCP
-    // Shut TX only.
-    tcp_shutdown(self.pcb, 0, 1);
-    tcp_output(self.pcb);
-#endif
+    if (_sendQueue) {
+        // FIN MUST follow the queued bytes; drainSendQueueLocked sends it.
+        self.pendingShutdown = YES;
+        return;
+    }
+    [self shutdownWriteNowLocked];
 }
 
 - (void)gracefulClose {
@@ -362,6 +717,36 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     // inflight backpressure is enforced at recv-time via shouldAllowRecv:
 }
 
+- (void)noteReceiveWindowBytesLocked:(NSUInteger)bytes {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_rcv_wnd_note_received(&_rcvWndTuner, self.pcb, bytes);
+}
+
+- (void)updateReceiveWindowLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.pcb)
+        return;
+
+    tf_rcv_wnd_update(&_rcvWndTuner, self.pcb, self.inflightAckBytes);
+}
+
+- (void)noteSendBufferAckedLocked:(u16_t)len {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_snd_buf_note_acked(&_sndBufTuner, self.pcb, len, _sendQueue != nil);
+}
+
+- (void)updateSendBufferLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.pcb)
+        return;
+
+    tf_snd_buf_update(&_sndBufTuner, self.pcb);
+}
+
 - (void)tryGracefulCloseLocked {
     TF_ASSERT_ON_PACKETS_QUEUE();
 
@@ -375,6 +760,12 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
 
     self.state = TFTCPConnectionClosing;
 
+    if (_sendQueue) {
+        // Queued bytes are still owed to the peer. Retry in poll once drained.
+        self.pendingClose = YES;
+        return;
+    }
+
     err_t err = tcp_close(self.pcb);
     switch (err) {
     case ERR_OK:
@@ -453,11 +844,28 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     if (self.pcb) {
         [self clearCallbackLocked];
     }
+    // Stale from here on, for lwIP and for the ext-arg destroy callback alike.
+    tf_handle_free(_handle);
+    _handle = 0;
 
     self.alive = NO;
     self.state = TFTCPConnectionClosed;
     self.terminationReason = reason;
     self.pendingClose = NO;
+    self.pendingShutdown = NO;
+
+    _sendQueue = nil;
+    self.sendQueueLength = 0;
+    _turnCredit = 0;
+
+    // The pcb keeps whatever window / buffer it has; only the budgets are returned.
+    tf_rcv_wnd_stop(&_rcvWndTuner, NULL);
+    tf_snd_buf_stop(&_sndBufTuner, NULL);
+
+    if (_pendingRx) {
+        pbuf_free(_pendingRx);
+        _pendingRx = NULL;
+    }
 
     [TFTunForgeLog info:[NSString stringWithFormat:@"TCP terminated, reason=%ld", (long)reason]];
 
@@ -477,8 +885,456 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
     }];
 }
 
+#pragma mark - No-copy write ledger
+
+#if LWIP_TCP_PCB_NUM_EXT_ARGS > TUNFORGE_TCP_EXTARG_LEDGER_ID
+
+/// The pcb's ledger, created on first use. Owned by the ext-arg slot, so it outlives this
+/// connection when lwIP keeps the pcb (and its unacked segments) after close.
+- (nullable tf_send_ledger *)sendLedgerLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_send_ledger *ledger = tcp_ext_arg_get(self.pcb, TUNFORGE_TCP_EXTARG_LEDGER_ID);
+    if (ledger)
+        return ledger;
+
+    ledger = tf_send_ledger_create();
+    if (!ledger)
+        return NULL;
+
+    tcp_ext_arg_set_callbacks(self.pcb, TUNFORGE_TCP_EXTARG_LEDGER_ID, &tf_tcp_ledger_cbs);
+    tcp_ext_arg_set(self.pcb, TUNFORGE_TCP_EXTARG_LEDGER_ID, ledger);
+    return ledger;
+}
+
+- (void)releaseAckedWritesLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_send_ledger *ledger = tcp_ext_arg_get(self.pcb, TUNFORGE_TCP_EXTARG_LEDGER_ID);
+    if (ledger) {
+        tf_send_ledger_acknowledge(ledger, self.pcb->lastack);
+    }
+}
+
+static void tf_tcp_ledger_destroy(u8_t ID, void *arg) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+    LWIP_UNUSED_ARG(ID);
+
+    // pcb freed: no segment references caller buffers any more.
+    if (arg) {
+        tf_send_ledger_destroy((tf_send_ledger *)arg);
+    }
+}
+
+static const struct tcp_ext_arg_callbacks tf_tcp_ledger_cbs = {.destroy = tf_tcp_ledger_destroy};
+
+#endif
+
+#pragma mark - Vectored write
+
+/// Returns NO with `result` filled when there is nothing to write or no way to write it.
+- (BOOL)beginVectorWriteLocked:(tf_tcp_vector_write *)w result:(TFTCPWriteResult *)result {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.alive || !self.pcb || self.state != TFTCPConnectionActive || self.writeFIN) {
+        *result = (TFTCPWriteResult){.written = 0, .status = TFTCPWriteClosed};
+        return NO;
+    }
+
+    if (w->total == 0) {
+        *result = (TFTCPWriteResult){.written = 0, .status = TFTCPWriteOK};
+        return NO;
+    }
+
+    [self drainSendQueueLocked];
+    if (!self.alive || !self.pcb) {
+        *result = (TFTCPWriteResult){.written = 0, .status = TFTCPWriteError};
+        return NO;
+    }
+
+    w->pcb = self.pcb;
+    // While bytes are queued, new ones queue behind them.
+    w->budget = _sendQueue ? 0 : tcp_sndbuf(self.pcb);
+    w->room = [self sendQueueRoomLocked];
+    w->more = self.corked;
+    w->err = ERR_OK;
+    if (w->budget == 0 && w->room == 0) {
+        [self updateWritableLocked:NO];
+        *result = (TFTCPWriteResult){.written = 0, .status = TFTCPWriteWouldBlock};
+        return NO;
+    }
+
+    if (w->whole) {
+        if (w->budget + w->room < w->total) {
+            [self updateWritableLocked:NO];
+            *result = (TFTCPWriteResult){.written = 0, .status = TFTCPWriteWouldBlock};
+            return NO;
+        }
+        // tcp_write may stop short of tcp_sndbuf (segment limit): the rest still queues,
+        // overshooting the high watermark by less than `total`.
+        w->room = w->total;
+    }
+    return YES;
+}
+
+/// One tcp_output for everything queued; `written` may be short of `total`.
+- (TFTCPWriteResult)finishVectorWriteLocked:(const tf_tcp_vector_write *)w {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (w->err != ERR_OK && w->err != ERR_MEM) {
+        // Other errors are fatal
+        [self abortLocked:TFTCPConnectionTerminationReasonAbort];
+        return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteError};
+    }
+
+    if (w->written + w->queued == 0) {
+        [self updateWritableLocked:NO];
+        return (TFTCPWriteResult){.written = 0, .status = TFTCPWriteWouldBlock};
+    }
+
+    if (w->written > 0 && !self.corked) {
+        tcp_output(self.pcb);
+    }
+    [self refreshWritableLocked];
+    return (TFTCPWriteResult){.written = w->written + w->queued, .status = TFTCPWriteOK};
+}
+
+#pragma mark - Send queue
+
+- (NSUInteger)sendQueueRoomLocked {
+    NSUInteger high = self.sendQueueHighWatermark;
+    return high > self.sendQueueLength ? high - self.sendQueueLength : 0;
+}
+
+- (void)appendSendQueueLocked:(dispatch_data_t)data {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    _sendQueue = _sendQueue ? dispatch_data_create_concat(_sendQueue, data) : data;
+    self.sendQueueLength = dispatch_data_get_size(_sendQueue);
+}
+
+/// Moves queued bytes into lwIP as far as tcp_sndbuf allows; called from tcp_sent / tcp_poll
+/// (lwIP outputs right after those) and before every queued write.
+/// Returns NO if the pcb was aborted: a callback must then return ERR_ABRT.
+- (BOOL)drainSendQueueLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!_sendQueue || !self.pcb)
+        return YES;
+
+    __block tf_tcp_vector_write w = {
+        .pcb = self.pcb,
+        .total = self.sendQueueLength,
+        .budget = tcp_sndbuf(self.pcb),
+        .more = self.corked,
+        .err = ERR_OK,
+    };
+    if (w.budget > 0) {
+        dispatch_data_apply(_sendQueue, ^bool(dispatch_data_t region, size_t offset,
+                                              const void *buffer, size_t size) {
+            return tf_tcp_write_region(&w, buffer, size);
+        });
+    }
+
+    if (w.err != ERR_OK && w.err != ERR_MEM) {
+        // Other errors are fatal
+        [self abortLocked:TFTCPConnectionTerminationReasonAbort];
+        return NO;
+    }
+
+    if (w.written < w.total) {
+        if (w.written > 0) {
+            _sendQueue = dispatch_data_create_subrange(_sendQueue, w.written, w.total - w.written);
+            self.sendQueueLength = w.total - w.written;
+        }
+        return YES;
+    }
+
+    _sendQueue = nil;
+    self.sendQueueLength = 0;
+
+    if (self.pendingShutdown) {
+        self.pendingShutdown = NO;
+        [self shutdownWriteNowLocked];
+    }
+    if (self.pendingClose) {
+        // Don't leave the close to the next tcp_poll.
+        [self tryGracefulCloseLocked];
+        return self.alive || self.terminationReason != TFTCPConnectionTerminationReasonAbort;
+    }
+    return YES;
+}
+
+/// `writable` follows the send queue when it is enabled: NO from the high watermark until
+/// the queue is back at the low one.
+- (void)refreshWritableLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    NSUInteger high = self.sendQueueHighWatermark;
+    if (high == 0) {
+        [self updateWritableLocked:tf_tcp_write_ready(self.pcb)];
+        return;
+    }
+
+    NSUInteger queued = self.sendQueueLength;
+    if (queued >= high) {
+        [self updateWritableLocked:NO];
+    } else if (queued <= MIN(self.sendQueueLowWatermark, high - 1)) {
+        [self updateWritableLocked:YES];
+    }
+}
+
+- (void)shutdownWriteNowLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+#if LWIP_TCP
+    // Shut TX only.
+    tcp_shutdown(self.pcb, 0, 1);
+    tcp_output(self.pcb);
+#endif
+}
+
+#pragma mark - Receive coalescing
+
+- (void)enqueueReceivedLocked:(struct pbuf *)p {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    // pbuf tot_len is u16_t: deliver what we have before the chain would overflow it.
+    if (_pendingRx && (u32_t)_pendingRx->tot_len + p->tot_len > UINT16_MAX) {
+        [self flushReceivedLocked];
+        if (!self.alive) {
+            pbuf_free(p);
+            return;
+        }
+    }
+
+    if (_pendingRx) {
+        pbuf_cat(_pendingRx, p);
+        return;
+    }
+
+    _pendingRx = p;
+    TFPacketsTurnEnlist(self, TFPacketsTurnStageConnections);
+}
+
+/// Hands the coalesced chain to `onReadableBytes` as one slice array with one completion.
+- (void)flushReceivedLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    struct pbuf *p = _pendingRx;
+    if (!p)
+        return;
+    _pendingRx = NULL;
+
+    const u16_t tot = p->tot_len;
+    TFTCPReadableBytesBatchHandler onReadableBytesCopy = self.onReadableBytes;
+    if (!onReadableBytesCopy || !self.alive) {
+        // Handler detached since enqueue: drop, crediting what was reserved.
+        [self acknowledgeDeliveredBytes:tot];
+        pbuf_free(p);
+        return;
+    }
+
+    NSUInteger sliceCnt = 0;
+    for (struct pbuf *q = p; q; q = q->next) {
+        sliceCnt++;
+    }
+
+    TFSliceSource source;
+    TFBytesSlice *slices = [self acquireSlicesLocked:sliceCnt source:&source];
+    tf_rx_release *release = slices ? tf_rx_release_alloc() : NULL;
+    if (!release) {
+        if (slices && source == TFSliceSourceInline) {
+            [self releaseInlineSlicesLocked];
+        } else if (slices) {
+            tf_slices_release(slices, sliceCnt, source);
+        }
+        pbuf_free(p);
+        // These bytes are ACKed to the peer already: going on without them would
+        // corrupt the stream.
+        [TFTunForgeLog error:@"TCP receive delivery allocation failed; abort"];
+        [self abortLocked:TFTCPConnectionTerminationReasonAbort];
+        return;
+    }
+
+    // The release holds self, keeping an inline slice array alive until drained.
+    release->conn = (__bridge_retained void *)self;
+    release->p = p;
+    release->slices = slices;
+    release->sliceCount = sliceCnt;
+    release->source = source;
+
+    struct pbuf *q = p;
+    for (NSUInteger i = 0; i < sliceCnt; i++) {
+        slices[i].bytes = q->payload;
+        slices[i].length = q->len;
+        q = q->next;
+    }
+
+    weakify(self);
+    [TFGlobalScheduler.shared connectionsPerformAsync:^{
+        strongify(self);
+        if (!self || !self.alive || !onReadableBytesCopy) {
+            // must free even if handler gone
+            tf_rx_release_push(release);
+            return;
+        }
+
+        // No packetsQueue hop per completion: releases are batched (tf_rx_release_drain).
+        onReadableBytesCopy(self, slices, sliceCnt, tot, ^{
+            tf_rx_release_push(release);
+        });
+    }];
+}
+
+#pragma mark - Refused data
+
+/// lwIP parks data tf_tcp_recv refused (ERR_MEM) in refused_data and retries only from
+/// tcp_fasttmr. Once the receive gate or window reopens, retry at the end of this turn,
+/// outside any lwIP callback.
+- (void)scheduleRefusedRedeliveryLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.pcb || !self.pcb->refused_data || self.redeliverRefused)
+        return;
+    if (![self shouldAllowRecv:self.pcb])
+        return;
+
+    self.redeliverRefused = YES;
+    TFPacketsTurnEnlist(self, TFPacketsTurnStageConnections);
+}
+
+- (void)redeliverRefusedLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.redeliverRefused)
+        return;
+    self.redeliverRefused = NO;
+
+    if (!self.alive || !self.pcb)
+        return;
+
+    // Re-enters tf_tcp_recv, which detaches the pcb itself if it aborts.
+    tcp_tunforge_process_refused(self.pcb);
+}
+
+#pragma mark - Send notifications
+
+- (void)noteSentBytesLocked:(u16_t)len {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (!self.onSentBytes)
+        return;
+
+    self.unreportedSentBytes += len;
+    TFPacketsTurnEnlist(self, TFPacketsTurnStageConnections);
+}
+
+/// One connectionsQueue hop per turn: the ACKed bytes summed since the last report (once
+/// past sentBytesNotifyThreshold, or when nothing is left in flight), then the final
+/// writable state if it differs from the last one reported.
+- (void)flushSendNotificationsLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    NSUInteger sentBytes = self.unreportedSentBytes;
+    TFTCPSentBytesHandler onSentBytesCopy = self.onSentBytes;
+    if (sentBytes > 0 && onSentBytesCopy) {
+        BOOL idle = !self.pcb || (!self.pcb->unacked && !self.pcb->unsent);
+        if (sentBytes >= self.sentBytesNotifyThreshold || idle) {
+            self.unreportedSentBytes = 0;
+        } else {
+            onSentBytesCopy = nil;
+        }
+    } else {
+        onSentBytesCopy = nil;
+    }
+
+    TFTCPWritableChangedHandler onWritableChangedCopy = nil;
+    BOOL writable = self.writable;
+    if (writable != self.notifiedWritable) {
+        self.notifiedWritable = writable;
+        onWritableChangedCopy = self.onWritableChanged;
+    }
+
+    if (!onSentBytesCopy && !onWritableChangedCopy)
+        return;
+
+    weakify(self);
+    [TFGlobalScheduler.shared connectionsPerformAsync:^{
+        strongify(self);
+        if (!self || !self.alive)
+            return;
+
+        if (onSentBytesCopy)
+            onSentBytesCopy(self, sentBytes);
+        if (onWritableChangedCopy)
+            onWritableChangedCopy(self, writable);
+    }];
+}
+
+#pragma mark - TFPacketsTurnObserver
+
+/// Opens the receive window by this turn's credit in one step; a window-update ACK goes out
+/// only if the right edge moves by windowUpdateThreshold.
+- (void)applyTurnCreditLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    NSUInteger credit = _turnCredit;
+    if (credit == 0)
+        return;
+    _turnCredit = 0;
+
+    if (!self.alive || !self.pcb)
+        return;
+
+    tcp_tunforge_recved(self.pcb,
+                        (u32_t)MIN(credit, (NSUInteger)UINT32_MAX),
+                        (u32_t)MIN(self.windowUpdateThreshold, (NSUInteger)UINT32_MAX));
+    [self updateReceiveWindowLocked];
+
+    // Data refused for lack of window can go up now; redeliverRefusedLocked runs next.
+    [self scheduleRefusedRedeliveryLocked];
+}
+
+- (void)packetsTurnWillEnd {
+    [self applyTurnCreditLocked];
+    [self redeliverRefusedLocked];
+    [self flushReceivedLocked];
+    [self flushSendNotificationsLocked];
+}
+
 #pragma mark - Internal helpers
 
+/// Slice array for one `onReadableBytes` delivery: the inline buffer when it is free and
+/// large enough, else the global slice slab / heap.
+- (nullable TFBytesSlice *)acquireSlicesLocked:(NSUInteger)count source:(TFSliceSource *)source {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    if (count <= kTFInlineSliceCount && !_inlineSlicesBusy) {
+        _inlineSlicesBusy = YES;
+        tf_slices_note_inline();
+        *source = TFSliceSourceInline;
+        return _inlineSlices;
+    }
+    return tf_slices_acquire(count, source);
+}
+
+- (void)releaseInlineSlicesLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    _inlineSlicesBusy = NO;
+}
+
+- (void)applyPendingCreditLocked {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    // Re-arms _creditRelease: the drain MUST have read it before this point.
+    NSUInteger credit = atomic_exchange_explicit(&_pendingCredit, 0, memory_order_acq_rel);
+    if (credit > 0) {
+        [self acknowledgeDeliveredBytes:credit];
+    }
+}
+
 - (void)clearCallbackLocked {
     TF_ASSERT_ON_PACKETS_QUEUE();
 
@@ -491,9 +1347,8 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
         tcp_err(pcb, NULL);
     }
 
-    if (self.pcbRef) {
-        [self.pcbRef invalidate];
-    }
+    tf_handle_free(_handle);
+    _handle = 0;
 }
 
 - (void)notifyActiveOnceLocked {
@@ -525,19 +1380,10 @@ typedef NS_ENUM(NSInteger, TFTCPConnectionState) {
         return;
     self.writable = newValue;
 
-    TFTCPWritableChangedHandler onWritableChangedCopy = self.onWritableChanged;
-    if (!onWritableChangedCopy)
-        return;
-
-    weakify(self);
-    [TFGlobalScheduler.shared connectionsPerformAsync:^{
-        strongify(self);
-        if (!self || !self.alive)
-            return;
-
-        if (onWritableChangedCopy)
-            onWritableChangedCopy(self, newValue);
-    }];
+    // Reported once at turn end, and only if the final state differs.
+    if (self.onWritableChanged) {
+        TFPacketsTurnEnlist(self, TFPacketsTurnStageConnections);
+    }
 }
 
 #pragma mark - Alive guard via tcp_ext_arg (optional)
@@ -557,46 +1403,97 @@ static void tf_tcp_extarg_destroy(u8_t ID, void *arg) {
     TF_ASSERT_ON_PACKETS_QUEUE();
     LWIP_UNUSED_ARG(ID);
 
-    if (!arg)
-        return;
+    // Stale once the connection detached or terminated.
+    TFTCPConnection *conn = tf_handle_get((tf_handle)arg);
+    [conn receivedPcbDestroyed];
+}
+
+static const struct tcp_ext_arg_callbacks tf_tcp_extarg_cbs = {.destroy = tf_tcp_extarg_destroy};
+
+#endif
+
+#pragma mark - Receive release list
+
+// Completions from every connection, drained by one packetsQueue hop per burst.
+static tf_release_list tf_rx_release_list;
+
+// packetsQueue-owned cache of delivery nodes.
+static tf_rx_release *tf_rx_release_cache;
+static NSUInteger tf_rx_release_cache_count;
+static const NSUInteger kTFReleaseCacheMax = 1024;
+
+static tf_rx_release *tf_rx_release_alloc(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    tf_rx_release *release = tf_rx_release_cache;
+    if (release) {
+        tf_rx_release_cache = (tf_rx_release *)release->node.next;
+        tf_rx_release_cache_count--;
+        return release;
+    }
+    return (tf_rx_release *)malloc(sizeof(tf_rx_release));
+}
+
+static void tf_rx_release_recycle(tf_rx_release *release) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
 
-    TFObjectRef *ref = (__bridge TFObjectRef *)arg;
-    if (!ref)
+    if (tf_rx_release_cache_count >= kTFReleaseCacheMax) {
+        free(release);
         return;
+    }
+    release->node.next = (tf_release_node *)tf_rx_release_cache;
+    tf_rx_release_cache = release;
+    tf_rx_release_cache_count++;
+}
+
+/// Frees every finished delivery and applies every pending credit in one turn, so the
+/// resulting window updates leave as a single egress batch.
+static void tf_rx_release_drain(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    TFPacketsTurnBegin();
 
-    NSObject *obj = ref.object;
-    [ref invalidate];
+    tf_release_node *node = tf_release_list_take(&tf_rx_release_list);
+    while (node) {
+        tf_rx_release *release = (tf_rx_release *)node;
+        node = node->next;
+        TFTCPConnection *conn = (__bridge_transfer TFTCPConnection *)release->conn;
+
+        if (!release->p) {
+            [conn applyPendingCreditLocked];
+            continue;
+        }
 
-    if ([obj isKindOfClass:[TFTCPConnection class]]) {
-        [(TFTCPConnection *)obj receivedPcbDestroyed];
+        if (release->source == TFSliceSourceInline) {
+            [conn releaseInlineSlicesLocked];
+        } else {
+            tf_slices_release(release->slices, release->sliceCount, release->source);
+        }
+        pbuf_free(release->p);
+        tf_rx_release_recycle(release);
     }
 
-    TFObjectRefRelease(arg);
+    TFPacketsTurnEnd();
 }
 
-static const struct tcp_ext_arg_callbacks tf_tcp_extarg_cbs = {.destroy = tf_tcp_extarg_destroy};
+/// Any thread.
+static void tf_rx_release_push(tf_rx_release *release) {
+    if (!tf_release_list_push(&tf_rx_release_list, &release->node))
+        return; // a drain is already scheduled
 
-#endif
+    // A completion may run on packetsQueue inside lwIP.
+    tf_packets_defer(^{
+        tf_rx_release_drain();
+    });
+}
 
 #pragma mark - lwIP raw callbacks
 
+/// Only TFTCPConnection handles are ever stored in callback_arg.
 static inline TFTCPConnection *tf_conn_from_arg(void *arg) {
     TF_ASSERT_ON_PACKETS_QUEUE();
 
-    if (!arg)
-        return nil;
-    if (![(__bridge id)arg isKindOfClass:[TFObjectRef class]])
-        return nil;
-
-    TFObjectRef *ref = (__bridge TFObjectRef *)arg;
-    if (!ref.alive)
-        return nil;
-
-    id obj = ref.object;
-    if (!obj || ![obj isKindOfClass:[TFTCPConnection class]])
-        return nil;
-
-    return (TFTCPConnection *)obj;
+    return tf_handle_get((tf_handle)arg);
 }
 
 static err_t tf_tcp_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
@@ -619,6 +1516,10 @@ static err_t tf_tcp_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t e
 
     if (p == NULL) {
         // Peer FIN(from app, always) observed: event only (Rule 4: do not infer close).
+        // Bytes coalesced this turn MUST reach the upper layer before EOF.
+        [conn flushReceivedLocked];
+        if (!conn.alive)
+            return ERR_ABRT;
         [conn handlePeerFINLocked];
         return ERR_OK;
     }
@@ -636,52 +1537,15 @@ static err_t tf_tcp_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t e
     }
 
     [conn updateInflightAckBytes:tot];
+    [conn noteReceiveWindowBytesLocked:tot];
 
     // IMPORTANT:
     // Do NOT call tcp_recved here.
     // Upper layer calls -acknowledgeDeliveredBytes: after it has copied/enqueued bytes.
-    TFTCPReadableBytesBatchHandler onReadableBytesCopy = conn.onReadableBytes;
-    if (onReadableBytesCopy) {
-        NSUInteger sliceCnt = 0;
-        for (struct pbuf *q = p; q; q = q->next) {
-            sliceCnt++;
-        }
-
-        TFBytesSlice *slices = (TFBytesSlice *)malloc(sizeof(TFBytesSlice) * sliceCnt);
-        if (!slices) {
-            // fallback: drop safely
-            pbuf_free(p);
-            return ERR_OK;
-        }
-
-        struct pbuf *q = p;
-        for (NSUInteger i = 0; i < sliceCnt; i++) {
-            slices[i].bytes = q->payload;
-            slices[i].length = q->len;
-            q = q->next;
-        }
-
-        weakify(conn);
-        [TFGlobalScheduler.shared connectionsPerformAsync:^{
-            strongify(conn);
-            if (!conn || !conn.alive || !onReadableBytesCopy) {
-                // must free even if handler gone
-                [TFGlobalScheduler.shared packetsPerformAsync:^{
-                    free(slices);
-                    pbuf_free(p);
-                }];
-                return;
-            }
-
-            onReadableBytesCopy(conn, slices, sliceCnt, tot, ^{
-                [TFGlobalScheduler.shared packetsPerformAsync:^{
-                    free(slices);
-                    pbuf_free(p);
-                }];
-            });
-        }];
-
-        return ERR_OK;
+    if (conn.onReadableBytes) {
+        // Coalesced: delivered once at the end of this packetsQueue turn.
+        [conn enqueueReceivedLocked:p];
+        return conn.alive ? ERR_OK : ERR_ABRT;
     } else if (conn.onReadable) {
         // Compatibility path: Copy bytes out first.
         void *buf = malloc(tot);
@@ -725,21 +1589,23 @@ static err_t tf_tcp_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
     if (!conn || !conn.alive || conn.pcb != pcb)
         return ERR_OK;
 
+    // Before draining: whether writes were waiting on the buffer this ACK frees.
+    [conn noteSendBufferAckedLocked:len];
+
+    if (![conn drainSendQueueLocked])
+        return ERR_ABRT;
+    if (!conn.alive)
+        return ERR_OK; // closed gracefully, pcb still lwIP's
+
     // Observer-only hint
-    [conn updateWritableLocked:tf_tcp_write_ready(pcb)];
+    [conn refreshWritableLocked];
 
-    TFTCPSentBytesHandler onSentBytesCopy = conn.onSentBytes;
-    if (onSentBytesCopy) {
-        weakify(conn);
-        [TFGlobalScheduler.shared connectionsPerformAsync:^{
-            strongify(conn);
-            if (!conn || !conn.alive)
-                return;
+#if LWIP_TCP_PCB_NUM_EXT_ARGS > TUNFORGE_TCP_EXTARG_LEDGER_ID
+    [conn releaseAckedWritesLocked];
+#endif
 
-            if (onSentBytesCopy)
-                onSentBytesCopy(conn, len);
-        }];
-    }
+    [conn noteSentBytesLocked:len];
+    [conn updateSendBufferLocked];
 
     return ERR_OK;
 }
@@ -760,8 +1626,17 @@ static err_t tf_tcp_poll(void *arg, struct tcp_pcb *pcb) {
         }
     }
 
+    if (![conn drainSendQueueLocked])
+        return ERR_ABRT;
+    if (!conn.alive)
+        return ERR_OK; // closed gracefully, pcb still lwIP's
+
     // Optional observer-only hint
-    [conn updateWritableLocked:tf_tcp_write_ready(pcb)];
+    [conn refreshWritableLocked];
+
+    // Idle flows give grown receive window / send buffer back here.
+    [conn updateReceiveWindowLocked];
+    [conn updateSendBufferLocked];
 
     // Close retry (only if user requested graceful close and lwIP deferred it)
     if (conn.pendingClose) {
@@ -7,19 +7,117 @@
 
 #import <Foundation/Foundation.h>
 
-@class TFTCPConnectionInfo, TFTCPConnection;
+#import "TFTCPConnection.h"
+
+@class TFTCPConnectionInfo;
 
 NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - Outbound
 /// Outbound raw IP packet handler.
 ///
-/// Called from lwIP output path.
-/// Execution is asynchronous.
+/// Called on packetsQueue once per packetsQueue turn (input batch, timer tick, write burst)
+/// with every packet lwIP emitted during that turn.
+/// Maps directly onto `NEPacketTunnelFlow writePackets:withProtocols:`.
 typedef void (^OutboundHandler)(NSArray<NSData *> *packets, NSArray<NSNumber *> *families);
 
+/// One outbound IP packet, described in place over lwIP pbuf payloads (iovec-style).
+typedef struct {
+    const TFBytesSlice *slices;
+    NSUInteger sliceCount;
+    NSUInteger length;
+    int family;
+} TFPacketDescriptor;
+
+typedef void (^TFOutboundReleaseCompletion)(void);
+
+/// Zero-copy outbound handler.
+///
+/// Same batching as OutboundHandler, but no bytes are copied: descriptors point directly
+/// at lwIP pbufs, which are held until `completion` is called.
+/// `completion` MUST be called exactly once (any thread) to release internal buffers.
+/// lwIP does not retransmit a segment while it is held.
+typedef void (^TFOutboundBytesBatchHandler)(const TFPacketDescriptor *packets,
+                                            NSUInteger packetCount,
+                                            TFOutboundReleaseCompletion completion);
+
 typedef void (^TFTCPAcceptHandler)(BOOL accept);
 
+#pragma mark - Inbound
+
+typedef NS_ENUM(NSUInteger, TFIPStackIngressMode) {
+    /// Copy every inbound packet into the lwIP pbuf pool.
+    TFIPStackIngressModeCopy = 0,
+    /// Wrap the caller's NSMutableData in PBUF_REF pbufs; immutable NSData is copied.
+    /// Data lwIP has to park (out-of-order / refused) is copied into the pool at that point.
+    TFIPStackIngressModeZeroCopy
+};
+
+/// Releases a caller-owned inbound buffer. Invoked exactly once on packetsQueue.
+typedef void (^TFPacketReleaseHandler)(void);
+
+/// Pre-lwIP classification of an inbound packet.
+typedef NS_ENUM(NSUInteger, TFPacketClass) {
+    /// IPv4 TCP: handed to lwIP.
+    TFPacketClassTCP = 0,
+    /// IPv4 UDP / UDP-Lite (incl. QUIC).
+    TFPacketClassUDP,
+    TFPacketClassICMP,
+    TFPacketClassIPv6,
+    /// Any other IPv4 protocol.
+    TFPacketClassOther,
+    /// Unknown IP version, bad IHL or total length. Never diverted.
+    TFPacketClassMalformed
+};
+
+/// Receives inbound packets lwIP cannot use (UDP, ICMP, IPv6, other protocols).
+/// Called synchronously on packetsQueue. `packet` is the caller's buffer whenever possible
+/// (no copy) and may be retained.
+typedef void (^TFPacketDivertHandler)(NSData *packet, TFPacketClass packetClass);
+
+#pragma mark - Statistics
+
+/// Counters snapshot. Counters are monotonic since the stack was created.
+typedef struct {
+    /// NSData egress buffer slab (OutboundHandler path).
+    NSUInteger egressSlabCapacity;
+    NSUInteger egressSlabInUse;
+    NSUInteger egressSlabHighWater;
+    /// Outbound packets that fell back to a heap allocation because the slab was empty.
+    uint64_t egressSlabExhaustions;
+
+    /// Ingress admission control drops, per class.
+    uint64_t admissionDroppedSyn;
+    uint64_t admissionDroppedData;
+    /// Non-TCP or unparsable packets dropped above the high watermark.
+    uint64_t admissionDroppedOther;
+    /// Admitted packets dropped because the pbuf pool was exhausted anyway.
+    uint64_t ingressAllocFailures;
+
+    /// Inbound packets rejected by the pre-classifier, per class (dropped or diverted).
+    uint64_t ingressUDP;
+    uint64_t ingressICMP;
+    uint64_t ingressIPv6;
+    uint64_t ingressOtherProtocol;
+    uint64_t ingressMalformed;
+    /// Rejected packets handed to `divertHandler`.
+    uint64_t ingressDiverted;
+
+    /// Inbound TCP segments merged into a preceding segment by receive offload.
+    uint64_t ingressCoalescedSegments;
+
+    /// Large-send super-segments cut into MTU-sized packets.
+    uint64_t egressSuperSegments;
+    /// Outbound packets dropped because no egress buffer or batch could be allocated.
+    uint64_t egressAllocFailures;
+
+    /// Zero-copy receive deliveries by slice array source: the connection's inline buffer,
+    /// the global size-classed slab, or a heap fallback (no class fits / class exhausted).
+    uint64_t receiveSlicesInline;
+    uint64_t receiveSlicesSlab;
+    uint64_t receiveSlicesHeap;
+} TFIPStackStatistics;
+
 #pragma mark - Delegate
 
 @protocol TFIPStackDelegate <NSObject>
@@ -53,8 +151,88 @@ typedef void (^TFTCPAcceptHandler)(BOOL accept);
 /// Outbound raw IP packet handler.
 @property (nullable, nonatomic, copy) OutboundHandler outboundHandler;
 
+/// Zero-copy outbound handler. Takes precedence over `outboundHandler` when set.
+@property (nullable, nonatomic, copy) TFOutboundBytesBatchHandler outboundBytesHandler;
+
 @property (nullable, nonatomic, weak) id<TFIPStackDelegate> delegate;
 
+/// Ingress buffer ownership for `inputPacket:` / `inputPackets:`. Default is Copy.
+///
+/// NOTE:
+/// In ZeroCopy mode lwIP rewrites TCP header fields in place: only NSMutableData packets
+/// are wrapped, and their bytes are not preserved. Immutable NSData and fragmented packets
+/// always take the copy path.
+@property (nonatomic, assign) TFIPStackIngressMode ingressMode;
+
+/// GRO-style receive offload for `inputPackets:` / `inputPacketSlices:count:`. Default NO.
+///
+/// In-order segments of one flow within a batch (same 4-tuple, contiguous seq, flags ACK/PSH
+/// only, identical ack / window / options) are merged into one packet before lwIP sees them,
+/// so a bulk upload costs one tcp_input pass, one ACK and one delivery per merged run.
+/// In ZeroCopy mode the first segment's headers are rewritten in the caller's buffer.
+@property (nonatomic, assign) BOOL receiveOffloadEnabled;
+
+/// GSO-style large-send for connections accepted from now on. Default NO.
+///
+/// lwIP builds TCP segments of up to ~60 KB (bounded by cwnd and the peer window) and
+/// runs them through tcp_output / ip4_output once; `outputPacket` cuts them into MSS-sized
+/// IP packets from a header template with incrementally finished checksums.
+/// Congestion control still counts in real MSS units; a lost packet retransmits its
+/// whole super-segment.
+@property (nonatomic, assign) BOOL largeSendEnabled;
+
+/// Receive-window autotuning for connections accepted from now on. Default NO.
+///
+/// Each connection starts at TCP_WND and is resized every ~200 ms from how fast its
+/// delivered bytes are acknowledged (`acknowledgeDeliveredBytes:`): fast consumers grow up
+/// to what the window scale can announce, slow or idle ones shrink back.
+@property (nonatomic, assign) BOOL receiveWindowAutotuningEnabled;
+
+/// Window above TCP_WND all autotuned connections may hold together.
+/// Default: the lwIP pbuf pool size.
+@property (nonatomic, assign) NSUInteger receiveWindowBudget;
+
+/// Send-buffer autotuning for connections accepted from now on. Default NO.
+///
+/// Instead of TCP_SND_BUF each, connections start small and size their send buffer from
+/// their ACK rate and RTT every ~200 ms, growing while writes wait on it.
+@property (nonatomic, assign) BOOL sendBufferAutotuningEnabled;
+
+/// Send buffer above the initial size all autotuned connections may hold together.
+/// Default: a quarter of the lwIP heap (MEM_SIZE).
+@property (nonatomic, assign) NSUInteger sendBufferBudget;
+
+/// Stretch-ACK policy for `inputPackets:` / `inputPacketSlices:count:` batches.
+/// Default 0: lwIP's delayed ACK (every second segment).
+///
+/// In-order data is acknowledged once every `stretchAckSegments` MSS-sized segments or
+/// `stretchAckBytes` bytes (0: no byte bound), and anything still unacknowledged when the
+/// batch ends is acknowledged then. PSH, FIN and a peer that has used half of its
+/// advertised window are acknowledged immediately. Single `inputPacket:` calls keep
+/// lwIP's behaviour.
+@property (nonatomic, assign) NSUInteger stretchAckSegments;
+@property (nonatomic, assign) NSUInteger stretchAckBytes;
+
+/// Optional sink for inbound packets lwIP cannot use. When nil they are dropped.
+/// Either way they are rejected before any pbuf allocation or copy.
+@property (nullable, nonatomic, copy) TFPacketDivertHandler divertHandler;
+
+/// Ingress admission control, as the fraction of the lwIP pbuf pool in use.
+///
+/// - Above `admissionLowWatermark`: new connections (SYN without ACK) are dropped.
+/// - Above `admissionHighWatermark`: data for flows holding more than their share of the
+///   pool is dropped as well, and so are non-TCP packets.
+/// - ACK / FIN / RST segments carrying no data are always admitted.
+///
+/// Defaults: 0.75 / 0.9.
+@property (nonatomic, assign) double admissionLowWatermark;
+@property (nonatomic, assign) double admissionHighWatermark;
+
+/// The same levels for the lwIP heap, checked independently of the pool. The heap also
+/// backs queued send data, so it runs fuller in normal operation. Defaults: 0.85 / 0.95.
+@property (nonatomic, assign) double admissionHeapLowWatermark;
+@property (nonatomic, assign) double admissionHeapHighWatermark;
+
 - (void)start;
 
 - (void)stop;
@@ -62,6 +240,24 @@ typedef void (^TFTCPAcceptHandler)(BOOL accept);
 /// Inject a raw IP packet into lwIP.
 - (void)inputPacket:(nonnull NSData *)packet;
 
+/// Inject a batch of raw IP packets (e.g. one `readPackets` result) in one turn.
+/// ACKs and window updates produced by the batch are flushed once at the end.
+- (void)inputPackets:(NSArray<NSData *> *)packets;
+
+/// iovec-style variant of `inputPackets:`.
+/// Bytes are only borrowed for the duration of the call.
+- (void)inputPacketSlices:(const TFBytesSlice *)slices count:(NSUInteger)count;
+
+/// Zero-copy input of a caller-owned buffer, independent of `ingressMode`.
+/// `release` is invoked exactly once when lwIP no longer references `bytes`
+/// (immediately if the packet is copied or dropped).
+- (void)inputPacketBytesNoCopy:(void *)bytes
+                        length:(NSUInteger)length
+                       release:(TFPacketReleaseHandler)release;
+
+/// Snapshot of the stack counters. Safe to call from any thread (hops to packetsQueue).
+- (TFIPStackStatistics)statistics;
+
 @end
 
 NS_ASSUME_NONNULL_END
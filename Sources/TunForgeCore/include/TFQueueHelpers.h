@@ -64,3 +64,10 @@ static inline void tf_perform_async(dispatch_queue_t _Nonnull queue,
         dispatch_async(queue, block);
     }
 }
+
+/// Runs block on packetsQueue in a later turn, even when called on packetsQueue.
+///
+/// NOTE:
+/// Use this where the caller may be inside lwIP or inside a method of the object the block
+/// releases; tf_perform_async would run the block inline there.
+FOUNDATION_EXPORT void tf_packets_defer(dispatch_block_t _Nonnull block);
@@ -51,6 +51,9 @@ typedef struct {
 
 typedef void (^TFTCPReceiveGateCompletion)(void);
 
+/// Releases a caller-owned outbound buffer. Invoked exactly once on packetsQueue.
+typedef void (^TFTCPWriteReleaseHandler)(void);
+
 typedef void (^TFTCPActivatedHandler)(TFTCPConnection *conn);
 
 typedef void (^TFTCPReadableBytesBatchHandler)(TFTCPConnection *conn,
@@ -82,21 +85,65 @@ typedef void (^TFTCPTerminatedHandler)(TFTCPConnection *conn,
 @property (nullable, nonatomic, copy) TFTCPReadableHandler onReadable;
 
 /// Zero-copy receive path.
+/// Segments received during one packetsQueue turn are coalesced into a single call
+/// (at most UINT16_MAX bytes); onReadEOF always follows the last delivery.
 /// `completion` MUST be called exactly once to release internal buffers.
 @property (nullable, nonatomic, copy) TFTCPReadableBytesBatchHandler onReadableBytes;
 
 /// lwIP send-buffer writability changes
 /// (i.e. ability to send data *to the Peer / App* via lwIP TCP).
+/// Coalesced per packetsQueue turn: called with the final state, only if it changed.
 @property (nullable, nonatomic, copy) TFTCPWritableChangedHandler onWritableChanged;
 
-/// Peer ACKed sent data (tcp_sent); callback provides len (u16).
+/// Peer ACKed sent data (tcp_sent); callback provides the bytes ACKed since the last call,
+/// summed over at least one packetsQueue turn.
 @property (nullable, nonatomic, copy) TFTCPSentBytesHandler onSentBytes;
 
+/// Minimum ACKed bytes per onSentBytes call (0, default: every turn with ACKs).
+/// The remainder is still reported once nothing is left in flight.
+@property (nonatomic, assign) NSUInteger sentBytesNotifyThreshold;
+
 @property (nullable, nonatomic, copy) TFTCPReadEOFHandler onReadEOF;
 
 /// Termination callback (once).
 @property (nullable, nonatomic, copy) TFTCPTerminatedHandler onTerminated;
 
+/// Optional user-space send queue; 0 (default) disables it.
+/// When enabled, bytes lwIP has no room for are copied into the queue (up to the high
+/// watermark) and drained on packetsQueue from tcp_sent / tcp_poll as space frees up, so
+/// writes only return WouldBlock once the queue is full. `writable` then follows the queue:
+/// NO at the high watermark, YES again at or below the low one. Configure on packetsQueue.
+@property (nonatomic, assign) NSUInteger sendQueueHighWatermark;
+@property (nonatomic, assign) NSUInteger sendQueueLowWatermark;
+
+/// Bytes accepted by writes but not yet handed to lwIP.
+@property (nonatomic, assign, readonly) NSUInteger sendQueueLength;
+
+/// See -cork.
+@property (nonatomic, assign, readonly) BOOL corked;
+
+/// Nagle's algorithm (lwIP default: enabled); NO sets TCP_NODELAY behaviour.
+@property (nonatomic, assign) BOOL nagleEnabled;
+
+/// Receive-window autotuning (see TFIPStack.receiveWindowAutotuningEnabled).
+/// The window grows while the peer fills it and acknowledgements keep up, and shrinks
+/// when they fall behind. Disabling restores TCP_WND. Configure on packetsQueue.
+@property (nonatomic, assign) BOOL receiveWindowAutotuningEnabled;
+
+/// Send-buffer autotuning (see TFIPStack.sendBufferAutotuningEnabled).
+/// The buffer starts at TCP_SND_BUF / 8 and follows twice the measured bandwidth-delay
+/// product, up to TCP_SND_BUF. Disabling restores TCP_SND_BUF. Configure on packetsQueue.
+@property (nonatomic, assign) BOOL sendBufferAutotuningEnabled;
+
+/// Current send-buffer size of the connection (0 once the pcb is gone).
+@property (nonatomic, assign, readonly) NSUInteger sendBufferLimit;
+
+/// Minimum right-edge advance, in bytes, that sends a pure window-update ACK
+/// (0, default: lwIP's TCP_WND_UPDATE_THRESHOLD; capped at half the window).
+/// Credit from `acknowledgeDeliveredBytes:` is summed and applied once per packetsQueue turn;
+/// smaller advances ride on the next outgoing segment. Configure on packetsQueue.
+@property (nonatomic, assign) NSUInteger windowUpdateThreshold;
+
 - (instancetype)initWithTCPPcb:(struct tcp_pcb *)pcb;
 
 - (instancetype)init NS_UNAVAILABLE;
@@ -110,10 +157,16 @@ typedef void (^TFTCPTerminatedHandler)(TFTCPConnection *conn,
 - (void)setInboundDeliveryEnabled:(BOOL)enabled;
 
 /// Credits lwIP receive window after upper layer has consumed inbound bytes.
+/// The window opens when the current packetsQueue turn ends (see windowUpdateThreshold).
 - (void)acknowledgeDeliveredBytes:(NSUInteger)bytes;
 
+/// Thread-safe -acknowledgeDeliveredBytes:. Credit from all connections is summed and
+/// applied in one batched packetsQueue turn, together with receive-completion releases.
+- (void)acknowledgeDeliveredBytesAsync:(NSUInteger)bytes;
+
 /// Zero-copy style write API.
 /// NOTE:
+/// All-or-nothing, send queue or not: `written` is either `length` or 0 (WouldBlock).
 // Contract: caller MUST ensure length <= UINT16_MAX, length > 0
 - (TFTCPWriteResult)writeBytes:(const void *)bytes length:(NSUInteger)length;
 
@@ -121,6 +174,38 @@ typedef void (^TFTCPTerminatedHandler)(TFTCPConnection *conn,
 // Ensures that data length is within bounds (<= UINT16_MAX).
 - (TFTCPWriteResult)writeData:(NSData *)data;
 
+/// No-copy write: lwIP segments reference `bytes` directly, including for retransmission.
+/// `bytes` MUST stay valid and unmodified until `release` runs, which happens once the peer
+/// has ACKed every byte of it (or the connection is gone) and no egress batch still reads it.
+/// `release` is only retained on TFTCPWriteOK; otherwise the caller keeps ownership.
+/// Returns WouldBlock while the send queue holds bytes (they must go out first).
+/// Contract: caller MUST ensure length <= UINT16_MAX, length > 0
+- (TFTCPWriteResult)writeBytesNoCopy:(const void *)bytes
+                              length:(NSUInteger)length
+                             release:(TFTCPWriteReleaseHandler)release;
+
+/// Vectored write without the UINT16_MAX limit: queues as many leading bytes of `slices`
+/// as the send buffer accepts, with one tcp_output for the whole call.
+/// `written` is the exact number of bytes taken (status OK, possibly short of the total);
+/// the caller resubmits the rest after onWritableChanged / onSentBytes.
+/// WouldBlock means nothing was taken. With the send queue enabled, `written` counts queued
+/// bytes too.
+- (TFTCPWriteResult)writeSlices:(const TFBytesSlice *)slices count:(NSUInteger)count;
+
+/// -writeSlices:count: over the regions of `data`.
+- (TFTCPWriteResult)writeDispatchData:(dispatch_data_t)data;
+
+/// Batches writes: while corked they are queued with TCP_WRITE_FLAG_MORE and no tcp_output,
+/// and lwIP holds back a trailing partial segment (full-MSS segments may still leave).
+/// A FIN (shutdownWrite / close) always goes out.
+- (void)cork;
+
+/// Clears the cork and sends everything pending.
+- (void)uncork;
+
+/// Sends everything pending, including a partial tail; a corked connection stays corked.
+- (void)flush;
+
 /// Half-close (Shut down send side).
 - (void)shutdownWrite;
 
@@ -0,0 +1,208 @@
+//
+//  AdmissionControlTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFIPStack.h"
+#import "TFTestSupport.h"
+
+#import "lwip/memp.h"
+#import "lwip/priv/tcp_priv.h"
+#import "lwip/prot/ip.h"
+#import "lwip/stats.h"
+#import "lwip/tcp.h"
+
+@interface TFIPStack (AdmissionTesting)
+- (BOOL)admitInboundLocked:(const void *)bytes length:(u16_t)len;
+@end
+
+enum { kTFTestPayloadLength = 1000, kTFTestPacketCapacity = 1100 };
+
+static const u32_t kTFTestPeer = 0x0A000002;  // 10.0.0.2
+static const u32_t kTFTestLocal = 0x0A000001; // 10.0.0.1
+static const u16_t kTFTestLocalPort = 80;
+
+/// Pool usage for the next admission decisions; the heap stays idle.
+static void tf_test_set_pool_usage(double usage) {
+    struct stats_mem *pool = lwip_stats.memp[MEMP_PBUF_POOL];
+    pool->used = (mem_size_t)(pool->avail * usage);
+    lwip_stats.mem.used = 0;
+}
+
+static void tf_test_set_heap_usage(double usage) {
+    lwip_stats.memp[MEMP_PBUF_POOL]->used = 0;
+    lwip_stats.mem.used = (mem_size_t)(lwip_stats.mem.avail * usage);
+}
+
+/// An active pcb for peer:`port` -> local:80 holding `ooseq` bytes out of order on top of
+/// some unread in-order data, accounted the way tcp_receive() leaves it.
+static struct tcp_pcb *tf_test_flow(u16_t port, u32_t ooseq) {
+    struct tcp_pcb *pcb = TFTestEstablishedPCB();
+    ip_addr_set_ip4_u32(&pcb->local_ip, PP_HTONL(kTFTestLocal));
+    ip_addr_set_ip4_u32(&pcb->remote_ip, PP_HTONL(kTFTestPeer));
+    pcb->local_port = kTFTestLocalPort;
+    pcb->remote_port = port;
+    TCP_REG_ACTIVE(pcb);
+
+    pcb->rcv_nxt += kTFTestPayloadLength;
+    pcb->rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd - kTFTestPayloadLength);
+    tcp_tunforge_rx_account(pcb);
+    pcb->tunforge_ooseq_bytes = ooseq;
+    return pcb;
+}
+
+@interface AdmissionControlTests : XCTestCase
+@end
+
+@implementation AdmissionControlTests {
+    TFIPStack *_stack;
+    mem_size_t _poolUsed;
+    mem_size_t _heapUsed;
+    u8_t _packet[kTFTestPacketCapacity];
+}
+
+- (void)setUp {
+    TFTestSetUp();
+    _stack = TFIPStack.defaultStack;
+    TFTestOnPacketsQueue(^{
+        self->_poolUsed = lwip_stats.memp[MEMP_PBUF_POOL]->used;
+        self->_heapUsed = lwip_stats.mem.used;
+    });
+}
+
+- (void)tearDown {
+    TFTestOnPacketsQueue(^{
+        lwip_stats.memp[MEMP_PBUF_POOL]->used = self->_poolUsed;
+        lwip_stats.mem.used = self->_heapUsed;
+    });
+}
+
+/// Writes a TCP segment from peer:`port` carrying `payloadLength` bytes into `_packet`.
+- (u16_t)buildFromPort:(u16_t)port flags:(u8_t)flags payloadLength:(u16_t)payloadLength {
+    static const u8_t payload[kTFTestPayloadLength];
+    TFTestTCPHeader header = {
+        .src = kTFTestPeer,
+        .dst = kTFTestLocal,
+        .sport = port,
+        .dport = kTFTestLocalPort,
+        .seq = 1000,
+        .ack = 1,
+        .flags = flags,
+        .wnd = 0xffff,
+    };
+    return TFTestBuildTCPPacket(_packet, &header, payload, payloadLength, YES);
+}
+
+- (BOOL)admitFromPort:(u16_t)port flags:(u8_t)flags payloadLength:(u16_t)payloadLength {
+    u16_t len = [self buildFromPort:port flags:flags payloadLength:payloadLength];
+    return [_stack admitInboundLocked:_packet length:len];
+}
+
+- (BOOL)admitSyn {
+    return [self admitFromPort:40000 flags:TCP_SYN payloadLength:0];
+}
+
+- (BOOL)admitData:(u16_t)port {
+    return [self admitFromPort:port flags:TCP_ACK | TCP_PSH payloadLength:kTFTestPayloadLength];
+}
+
+/// Payload-free ACK / FIN / RST.
+- (BOOL)admitControl {
+    return [self admitFromPort:40000 flags:TCP_ACK payloadLength:0] &&
+           [self admitFromPort:40000 flags:TCP_ACK | TCP_FIN payloadLength:0] &&
+           [self admitFromPort:40000 flags:TCP_RST payloadLength:0];
+}
+
+/// Anything but TCP; only the protocol field is looked at.
+- (BOOL)admitUDP {
+    u16_t len = [self buildFromPort:40000 flags:TCP_ACK payloadLength:kTFTestPayloadLength];
+    IPH_PROTO_SET((struct ip_hdr *)_packet, IP_PROTO_UDP);
+    return [_stack admitInboundLocked:_packet length:len];
+}
+
+- (void)testAdmitsEverythingBelowLowWatermark {
+    TFTestOnPacketsQueue(^{
+        TFIPStackStatistics before = [self->_stack statistics];
+        tf_test_set_pool_usage(self->_stack.admissionLowWatermark / 2);
+
+        XCTAssertTrue([self admitSyn]);
+        XCTAssertTrue([self admitControl]);
+        XCTAssertTrue([self admitData:40000]);
+        XCTAssertTrue([self admitUDP]);
+
+        TFIPStackStatistics after = [self->_stack statistics];
+        XCTAssertEqual(after.admissionDroppedSyn, before.admissionDroppedSyn);
+        XCTAssertEqual(after.admissionDroppedData, before.admissionDroppedData);
+        XCTAssertEqual(after.admissionDroppedOther, before.admissionDroppedOther);
+    });
+}
+
+- (void)testDropsOnlySynBetweenWatermarks {
+    TFTestOnPacketsQueue(^{
+        TFIPStackStatistics before = [self->_stack statistics];
+        tf_test_set_pool_usage(
+            (self->_stack.admissionLowWatermark + self->_stack.admissionHighWatermark) / 2);
+
+        XCTAssertFalse([self admitSyn]);
+        XCTAssertTrue([self admitControl]);
+        XCTAssertTrue([self admitData:40000]);
+        XCTAssertTrue([self admitUDP]);
+
+        TFIPStackStatistics after = [self->_stack statistics];
+        XCTAssertEqual(after.admissionDroppedSyn, before.admissionDroppedSyn + 1);
+        XCTAssertEqual(after.admissionDroppedData, before.admissionDroppedData);
+        XCTAssertEqual(after.admissionDroppedOther, before.admissionDroppedOther);
+    });
+}
+
+/// Two flows hold receive-side bytes, so each may hold half the pool: only the flow past its
+/// half loses data. Control segments still get through.
+- (void)testDropsDataBeyondFlowShareAboveHighWatermark {
+    TFTestOnPacketsQueue(^{
+        const u32_t poolBytes = (u32_t)PBUF_POOL_SIZE * PBUF_POOL_BUFSIZE;
+        struct tcp_pcb *hog = tf_test_flow(40001, poolBytes / 2);
+        struct tcp_pcb *light = tf_test_flow(40002, 0);
+
+        TFIPStackStatistics before = [self->_stack statistics];
+        tf_test_set_pool_usage((self->_stack.admissionHighWatermark + 1) / 2);
+
+        XCTAssertFalse([self admitSyn]);
+        XCTAssertTrue([self admitControl]);
+        XCTAssertFalse([self admitData:40001], @"hog is over its share");
+        XCTAssertTrue([self admitData:40002], @"light flow is within its share");
+        XCTAssertFalse([self admitUDP]);
+
+        TFIPStackStatistics after = [self->_stack statistics];
+        XCTAssertEqual(after.admissionDroppedSyn, before.admissionDroppedSyn + 1);
+        XCTAssertEqual(after.admissionDroppedData, before.admissionDroppedData + 1);
+        XCTAssertEqual(after.admissionDroppedOther, before.admissionDroppedOther + 1);
+
+        tcp_abort(hog);
+        tcp_abort(light);
+    });
+}
+
+- (void)testHeapWatermarksApplyWithIdlePool {
+    TFTestOnPacketsQueue(^{
+        const u32_t poolBytes = (u32_t)PBUF_POOL_SIZE * PBUF_POOL_BUFSIZE;
+        struct tcp_pcb *hog = tf_test_flow(40001, poolBytes);
+
+        tf_test_set_heap_usage(
+            (self->_stack.admissionHeapLowWatermark + self->_stack.admissionHeapHighWatermark) /
+            2);
+        XCTAssertFalse([self admitSyn]);
+        XCTAssertTrue([self admitData:40001]);
+
+        tf_test_set_heap_usage((self->_stack.admissionHeapHighWatermark + 1) / 2);
+        XCTAssertTrue([self admitControl]);
+        XCTAssertFalse([self admitData:40001]);
+
+        tcp_abort(hog);
+    });
+}
+
+@end
@@ -0,0 +1,85 @@
+//
+//  EgressFenceTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFEgressFence.h"
+#import "TFTestSupport.h"
+
+/// Fence state is process-wide: every test closes each fence it opens.
+@interface EgressFenceTests : XCTestCase
+@end
+
+@implementation EgressFenceTests {
+    NSMutableArray<NSString *> *_ran;
+}
+
+- (void)setUp {
+    TFTestSetUp();
+    _ran = [NSMutableArray array];
+}
+
+- (dispatch_block_t)waiter:(NSString *)name {
+    NSMutableArray<NSString *> *ran = _ran;
+    return ^{
+        [ran addObject:name];
+    };
+}
+
+- (void)testRunsAtOnceWithoutOpenFence {
+    TFTestOnPacketsQueue(^{
+        tf_egress_fence_after([self waiter:@"A"]);
+        XCTAssertEqualObjects(self->_ran, @[ @"A" ]);
+    });
+}
+
+/// f1, A, f2, B: closing f2 first frees nothing, since A and B both wait on f1.
+- (void)testNewerFenceClosingFirstHoldsOlderWaiters {
+    TFTestOnPacketsQueue(^{
+        tf_egress_fence f1 = tf_egress_fence_open();
+        tf_egress_fence_after([self waiter:@"A"]);
+        tf_egress_fence f2 = tf_egress_fence_open();
+        tf_egress_fence_after([self waiter:@"B"]);
+
+        tf_egress_fence_close(f2);
+        XCTAssertEqualObjects(self->_ran, @[]);
+
+        tf_egress_fence_close(f1);
+        XCTAssertEqualObjects(self->_ran, (@[ @"A", @"B" ]));
+    });
+}
+
+/// f1, A, f2, B: closing f1 frees A only; B also waits on f2.
+- (void)testFencesClosingInOrderReleaseWaitersInOrder {
+    TFTestOnPacketsQueue(^{
+        tf_egress_fence f1 = tf_egress_fence_open();
+        tf_egress_fence_after([self waiter:@"A"]);
+        tf_egress_fence f2 = tf_egress_fence_open();
+        tf_egress_fence_after([self waiter:@"B"]);
+
+        tf_egress_fence_close(f1);
+        XCTAssertEqualObjects(self->_ran, @[ @"A" ]);
+
+        tf_egress_fence_close(f2);
+        XCTAssertEqualObjects(self->_ran, (@[ @"A", @"B" ]));
+    });
+}
+
+/// A fence opened after a waiter was queued does not hold it back.
+- (void)testLaterFenceDoesNotDelayEarlierWaiter {
+    TFTestOnPacketsQueue(^{
+        tf_egress_fence f1 = tf_egress_fence_open();
+        tf_egress_fence_after([self waiter:@"A"]);
+        tf_egress_fence f2 = tf_egress_fence_open();
+
+        tf_egress_fence_close(f1);
+        XCTAssertEqualObjects(self->_ran, @[ @"A" ]);
+        tf_egress_fence_close(f2);
+    });
+}
+
+@end
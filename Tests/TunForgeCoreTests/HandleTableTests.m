@@ -0,0 +1,78 @@
+//
+//  HandleTableTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFHandleTable.h"
+#import "TFTestSupport.h"
+
+@interface HandleTableTests : XCTestCase
+@end
+
+@implementation HandleTableTests
+
+- (void)setUp {
+    TFTestSetUp();
+}
+
+- (void)testZeroIsNeverValid {
+    TFTestOnPacketsQueue(^{
+        XCTAssertNil(tf_handle_get(0));
+    });
+}
+
+/// A freed slot is reused by the next alloc; handles issued before must stay stale.
+- (void)testStaleHandleMissesAfterFreeAndReuse {
+    TFTestOnPacketsQueue(^{
+        @autoreleasepool {
+            NSObject *first = [NSObject new];
+            NSObject *second = [NSObject new];
+
+            tf_handle stale = tf_handle_alloc(first);
+            XCTAssertNotEqual(stale, 0u);
+            XCTAssertTrue(tf_handle_get(stale) == first);
+
+            tf_handle_free(stale);
+            XCTAssertNil(tf_handle_get(stale));
+            tf_handle_free(stale); // no-op
+
+            tf_handle reused = tf_handle_alloc(second);
+            uintptr_t slotMask = ((uintptr_t)1 << kTFHandleSlotBits) - 1;
+            XCTAssertEqual(reused & slotMask, stale & slotMask, @"LIFO free list");
+            XCTAssertNotEqual(reused, stale);
+            XCTAssertNil(tf_handle_get(stale));
+            XCTAssertTrue(tf_handle_get(reused) == second);
+
+            tf_handle_free(reused);
+        }
+    });
+}
+
+/// Freeing from inside the object's own method must not deallocate it under the caller.
+- (void)testObjectOutlivesFreeUntilNextPacketsQueueTurn {
+    __block __weak NSObject *weakObject;
+    TFTestOnPacketsQueue(^{
+        @autoreleasepool {
+            tf_handle handle;
+            @autoreleasepool {
+                NSObject *object = [NSObject new];
+                weakObject = object;
+                handle = tf_handle_alloc(object);
+            }
+            tf_handle_free(handle);
+            XCTAssertNotNil(weakObject, @"released before the current turn ends");
+        }
+    });
+
+    TFTestOnPacketsQueue(^{
+        @autoreleasepool {
+            XCTAssertNil(weakObject);
+        }
+    });
+}
+
+@end
@@ -0,0 +1,206 @@
+//
+//  ReceiveOffloadTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFReceiveOffload.h"
+#import "TFTestSupport.h"
+
+#import "lwip/def.h"
+#import "lwip/pbuf.h"
+#import "lwip/prot/tcp.h"
+
+enum { kTFTestMaxPackets = 8, kTFTestMaxPacket = 0xffff };
+
+/// tf_gro_ops sink: copies offered bytes into pool pbufs and collects what reaches the netif.
+typedef struct {
+    struct pbuf *inputs[kTFTestMaxPackets];
+    NSUInteger count;
+} tf_test_gro_sink;
+
+static struct pbuf *tf_test_gro_alloc(void *ctx, const void *bytes, u16_t len, void *owner) {
+    (void)ctx;
+    (void)owner;
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    if (p) {
+        pbuf_take(p, bytes, len);
+    }
+    return p;
+}
+
+static void tf_test_gro_input(void *ctx, struct pbuf *p) {
+    tf_test_gro_sink *sink = (tf_test_gro_sink *)ctx;
+    if (sink->count < kTFTestMaxPackets) {
+        sink->inputs[sink->count++] = p;
+    } else {
+        pbuf_free(p);
+    }
+}
+
+@interface ReceiveOffloadTests : XCTestCase
+@end
+
+@implementation ReceiveOffloadTests {
+    tf_gro _gro;
+    tf_test_gro_sink _sink;
+    u8_t _payload[4 * 1460];
+    u8_t _packet[kTFTestMaxPacket];
+    u8_t _flat[kTFTestMaxPacket];
+}
+
+- (void)setUp {
+    TFTestSetUp();
+    memset(&_sink, 0, sizeof(_sink));
+    tf_gro_ops ops = {tf_test_gro_alloc, tf_test_gro_input, &_sink};
+    tf_gro_init(&_gro, &ops);
+    TFTestFillBytes(_payload, sizeof(_payload), 0);
+}
+
+- (void)tearDown {
+    tf_gro_flush(&_gro);
+    for (NSUInteger i = 0; i < _sink.count; i++) {
+        pbuf_free(_sink.inputs[i]);
+    }
+}
+
+- (TFTestTCPHeader)header {
+    static const u8_t timestamps[12] = {1, 1, 8, 10, 0, 0, 0, 1, 0, 0, 0, 2};
+    return (TFTestTCPHeader){
+        .src = 0x0a000002,
+        .dst = 0x0a000001,
+        .sport = 50000,
+        .dport = 443,
+        .seq = 1000,
+        .ack = 7000,
+        .flags = TCP_ACK,
+        .wnd = 4096,
+        .options = timestamps,
+        .optionsLength = sizeof(timestamps),
+    };
+}
+
+/// Offers one segment of `_payload[offset, offset + length)`.
+- (BOOL)offer:(TFTestTCPHeader)header offset:(NSUInteger)offset length:(u16_t)length {
+    header.seq += (u32_t)offset;
+    u16_t len = TFTestBuildTCPPacket(_packet, &header, _payload + offset, length, YES);
+    return tf_gro_offer(&_gro, _packet, len, NULL);
+}
+
+/// Flattens input `index` into `_flat`; returns its length.
+- (u16_t)flatten:(NSUInteger)index {
+    struct pbuf *p = _sink.inputs[index];
+    return pbuf_copy_partial(p, _flat, p->tot_len, 0);
+}
+
+#pragma mark - Tests
+
+/// Odd lengths put later segments at odd offsets of the merged payload: their checksums
+/// must be byte-swapped before folding.
+- (void)testMergedRunCarriesFullChecksumAtOddAndEvenOffsets {
+    const u16_t runs[][3] = {
+        {1, 2, 3}, {101, 100, 7}, {99, 99, 99}, {1460, 1459, 1}, {2, 1, 1460},
+    };
+    TFTestTCPHeader header = [self header];
+    for (NSUInteger r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        NSUInteger offset = 0;
+        for (NSUInteger i = 0; i < 3; i++) {
+            XCTAssertTrue([self offer:header offset:offset length:runs[r][i]]);
+            offset += runs[r][i];
+        }
+        XCTAssertEqual(_sink.count, 0u, @"run %lu held until flush", (unsigned long)r);
+        tf_gro_flush(&_gro);
+        XCTAssertEqual(_sink.count, 1u);
+
+        u16_t len = [self flatten:0];
+        u16_t hdrlen = (u16_t)(20 + 20 + header.optionsLength);
+        XCTAssertEqual(len, hdrlen + offset);
+        XCTAssertEqual(lwip_ntohs(*(const u16_t *)(_flat + 2)), len);
+        XCTAssertTrue(TFTestIPChecksumValid(_flat), @"run %lu", (unsigned long)r);
+        XCTAssertTrue(TFTestTCPChecksumValid(_flat, len), @"run %lu", (unsigned long)r);
+        XCTAssertEqual(memcmp(_flat + hdrlen, _payload, offset), 0);
+
+        pbuf_free(_sink.inputs[0]);
+        _sink.count = 0;
+        header.seq += 0x10000;
+    }
+    XCTAssertEqual(_gro.coalesced, 10u);
+}
+
+/// The merged checksum is derived from the segments' own: a corrupt one must not verify.
+- (void)testCorruptSegmentKeepsMergedChecksumInvalid {
+    TFTestTCPHeader header = [self header];
+    XCTAssertTrue([self offer:header offset:0 length:301]);
+
+    header.seq += 301;
+    u16_t len = TFTestBuildTCPPacket(_packet, &header, _payload + 301, 200, YES);
+    _packet[len - 17] ^= 0x5a;
+    XCTAssertTrue(tf_gro_offer(&_gro, _packet, len, NULL));
+    tf_gro_flush(&_gro);
+
+    XCTAssertEqual(_sink.count, 1u);
+    u16_t merged = [self flatten:0];
+    XCTAssertTrue(TFTestIPChecksumValid(_flat));
+    XCTAssertFalse(TFTestTCPChecksumValid(_flat, merged));
+}
+
+- (void)testPshEndsRunAndIsCarriedOver {
+    TFTestTCPHeader header = [self header];
+    XCTAssertTrue([self offer:header offset:0 length:500]);
+
+    TFTestTCPHeader push = header;
+    push.flags = TCP_ACK | TCP_PSH;
+    XCTAssertTrue([self offer:push offset:500 length:333]);
+    XCTAssertEqual(_sink.count, 1u, @"flushed on PSH, not at batch end");
+
+    u16_t len = [self flatten:0];
+    XCTAssertTrue(TFTestTCPChecksumValid(_flat, len));
+    XCTAssertEqual(_flat[20 + 13], TCP_ACK | TCP_PSH);
+
+    // Nothing can follow a PSH segment: a lone one is left to the caller.
+    XCTAssertFalse([self offer:push offset:833 length:10]);
+}
+
+- (void)testSequenceGapFlushesHeldRunFirst {
+    TFTestTCPHeader header = [self header];
+    XCTAssertTrue([self offer:header offset:0 length:100]);
+    XCTAssertTrue([self offer:header offset:100 length:100]);
+    XCTAssertTrue([self offer:header offset:300 length:100]);
+    XCTAssertEqual(_sink.count, 1u, @"run flushed before the out-of-order segment is held");
+    tf_gro_flush(&_gro);
+    XCTAssertEqual(_sink.count, 2u);
+
+    u16_t first = [self flatten:0];
+    XCTAssertEqual(first, 20 + 32 + 200);
+    XCTAssertTrue(TFTestTCPChecksumValid(_flat, first));
+
+    u16_t second = [self flatten:1];
+    XCTAssertEqual(second, 20 + 32 + 100);
+    XCTAssertEqual(lwip_ntohl(*(const u32_t *)(_flat + 24)), header.seq + 300);
+    XCTAssertTrue(TFTestTCPChecksumValid(_flat, second));
+}
+
+- (void)testFlowsAreCoalescedIndependently {
+    TFTestTCPHeader a = [self header];
+    TFTestTCPHeader b = a;
+    b.sport = 50001;
+    b.seq = 90000;
+
+    XCTAssertTrue([self offer:a offset:0 length:200]);
+    XCTAssertTrue([self offer:b offset:0 length:201]);
+    XCTAssertTrue([self offer:a offset:200 length:201]);
+    XCTAssertTrue([self offer:b offset:201 length:200]);
+    tf_gro_flush(&_gro);
+
+    XCTAssertEqual(_sink.count, 2u);
+    for (NSUInteger i = 0; i < 2; i++) {
+        u16_t len = [self flatten:i];
+        XCTAssertEqual(len, 20 + 32 + 401);
+        XCTAssertTrue(TFTestTCPChecksumValid(_flat, len));
+    }
+}
+
+@end
@@ -0,0 +1,190 @@
+//
+//  ReceiveWindowTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFReceiveWindow.h"
+#import "TFTestSupport.h"
+
+#import "lwip/priv/tcp_priv.h"
+#import "lwip/sys.h"
+#import "lwip/tcp.h"
+
+/// Simulates `len` in-order bytes arriving that the application has not read yet.
+static void tf_test_peer_sends(struct tcp_pcb *pcb, tcpwnd_size_t len) {
+    pcb->rcv_nxt += len;
+    pcb->rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd - len);
+}
+
+static void tf_test_consume(struct tcp_pcb *pcb, tcpwnd_size_t len) {
+    while (len > 0) {
+        u16_t chunk = (u16_t)LWIP_MIN(len, 0xffff);
+        tcp_recved(pcb, chunk);
+        len -= chunk;
+    }
+}
+
+/// Ends the tuner's epoch so the next tf_rcv_wnd_update() re-evaluates.
+static void tf_test_expire_epoch(tf_rcv_wnd_tuner *tuner) {
+    tuner->epochStartMs = sys_now() - 1000;
+}
+
+/// One epoch in which the sender runs the window nearly dry and the consumer keeps up.
+static void tf_test_run_limited_epoch(tf_rcv_wnd_tuner *tuner, struct tcp_pcb *pcb) {
+    tcpwnd_size_t len = (tcpwnd_size_t)(pcb->rcv_wnd - tuner->wndMax / 8);
+    tf_test_peer_sends(pcb, len);
+    tf_rcv_wnd_note_received(tuner, pcb, len);
+    tf_test_consume(pcb, len);
+    tf_test_expire_epoch(tuner);
+    tf_rcv_wnd_update(tuner, pcb, 0);
+}
+
+@interface ReceiveWindowTests : XCTestCase
+@end
+
+@implementation ReceiveWindowTests
+
+- (void)setUp {
+    TFTestSetUp();
+}
+
+/// rcv_wnd + held == TCP_WND_MAX must survive every resize, and no resize may pull back the
+/// right edge already announced to the peer.
+- (void)testResizeKeepsHeldBytesAndAnnouncedEdge {
+    TFTestOnPacketsQueue(^{
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        tcpwnd_size_t held = 10000;
+        tf_test_peer_sends(pcb, held);
+
+        // Growing clamps to what the scale can announce and announces it at once.
+        tcpwnd_size_t grown = tcp_tunforge_set_rcv_wnd_max(pcb, (tcpwnd_size_t)-1);
+        XCTAssertEqual(grown, TCP_WND_CEIL(pcb));
+        XCTAssertEqual(TCP_WND_MAX(pcb), grown);
+        XCTAssertEqual(TCP_WND_MAX(pcb) - pcb->rcv_wnd, held);
+        XCTAssertEqual(pcb->rcv_ann_right_edge, pcb->rcv_nxt + pcb->rcv_wnd);
+
+        // The peer fills the promise; a small read stays below the update threshold.
+        held += pcb->rcv_wnd;
+        tf_test_peer_sends(pcb, pcb->rcv_wnd);
+        tcp_recved(pcb, 1000);
+        held -= 1000;
+        u32_t edge = pcb->rcv_ann_right_edge;
+
+        // Shrinking stops at what is held plus still promised.
+        tcpwnd_size_t shrunk = tcp_tunforge_set_rcv_wnd_max(pcb, 4096);
+        XCTAssertEqual(shrunk, held + (edge - pcb->rcv_nxt));
+        XCTAssertLessThan(shrunk, grown);
+        XCTAssertEqual(TCP_WND_MAX(pcb) - pcb->rcv_wnd, held);
+        XCTAssertEqual(pcb->rcv_ann_right_edge, edge);
+
+        // Consuming the held bytes closes the window the rest of the way.
+        tf_test_consume(pcb, held);
+        XCTAssertEqual(TCP_WND_MAX(pcb), 4096);
+        XCTAssertEqual(pcb->rcv_wnd, TCP_WND_MAX(pcb));
+        XCTAssertTrue(TCP_SEQ_GEQ(pcb->rcv_ann_right_edge, edge));
+
+        // Nothing held, but the grown window was announced: still no retraction.
+        tcp_tunforge_set_rcv_wnd_max(pcb, grown);
+        edge = pcb->rcv_ann_right_edge;
+        tcp_tunforge_set_rcv_wnd_max(pcb, 4096);
+        XCTAssertEqual(TCP_WND_MAX(pcb), grown);
+        XCTAssertEqual(pcb->rcv_wnd, TCP_WND_MAX(pcb));
+        XCTAssertEqual(pcb->rcv_ann_right_edge, edge);
+
+        tcp_abort(pcb);
+    });
+}
+
+- (void)testDoublesWhenSenderRunsWindowLow {
+    TFTestOnPacketsQueue(^{
+        tf_rcv_wnd_set_budget((NSUInteger)TCP_WND * 64);
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        tf_rcv_wnd_tuner tuner = {};
+        tf_rcv_wnd_start(&tuner, pcb);
+        const uint32_t wnd = tuner.wndMax;
+        XCTAssertEqual(wnd, TCP_WND_DEFAULT(pcb));
+
+        // Nothing happens before the epoch is over.
+        tf_rcv_wnd_update(&tuner, pcb, 0);
+        XCTAssertEqual(tuner.wndMax, wnd);
+
+        tf_test_run_limited_epoch(&tuner, pcb);
+        XCTAssertEqual(tuner.wndMax, MIN(2 * wnd, (uint32_t)TCP_WND_CEIL(pcb)));
+        XCTAssertEqual(TCP_WND_MAX(pcb), tuner.wndMax);
+        XCTAssertEqual(pcb->rcv_wnd, TCP_WND_MAX(pcb));
+        XCTAssertEqual(pcb->rcv_ann_right_edge, pcb->rcv_nxt + pcb->rcv_wnd, @"announced at once");
+
+        tf_rcv_wnd_stop(&tuner, pcb);
+        tcp_abort(pcb);
+    });
+}
+
+/// Half the window waits on the consumer: the tuner halves it. lwIP keeps what is held and
+/// promised, then closes the window as the consumer catches up.
+- (void)testHalvesWhenConsumerFallsBehind {
+    TFTestOnPacketsQueue(^{
+        tf_rcv_wnd_set_budget((NSUInteger)TCP_WND * 64);
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        tf_rcv_wnd_tuner tuner = {};
+        tf_rcv_wnd_start(&tuner, pcb);
+        const uint32_t wnd = tuner.wndMax;
+
+        // The peer fills the window; the consumer acknowledges only a quarter.
+        tf_test_peer_sends(pcb, (tcpwnd_size_t)wnd);
+        tf_rcv_wnd_note_received(&tuner, pcb, wnd);
+        tf_test_consume(pcb, (tcpwnd_size_t)(wnd / 4));
+        const uint32_t backlog = wnd - wnd / 4;
+        u32_t edge = pcb->rcv_ann_right_edge;
+
+        tf_test_expire_epoch(&tuner);
+        tf_rcv_wnd_update(&tuner, pcb, backlog);
+        XCTAssertEqual(tuner.wndMax, wnd / 2);
+        XCTAssertEqual(TCP_WND_MAX(pcb), wnd, @"held + promised stay");
+        XCTAssertEqual(pcb->rcv_ann_right_edge, edge);
+
+        tf_test_consume(pcb, (tcpwnd_size_t)backlog);
+        XCTAssertEqual(TCP_WND_MAX(pcb), wnd / 2);
+        XCTAssertEqual(pcb->rcv_wnd, TCP_WND_MAX(pcb));
+        XCTAssertTrue(TCP_SEQ_GEQ(pcb->rcv_ann_right_edge, edge));
+
+        tf_rcv_wnd_stop(&tuner, pcb);
+        tcp_abort(pcb);
+    });
+}
+
+/// Growth of one pcb uses up the shared budget; the other grows once it is returned.
+- (void)testBudgetCapsGrowthAcrossPcbs {
+    TFTestOnPacketsQueue(^{
+        const NSUInteger budget = TCP_WND / 2;
+        tf_rcv_wnd_set_budget(budget);
+        struct tcp_pcb *first = TFTestEstablishedPCB();
+        struct tcp_pcb *second = TFTestEstablishedPCB();
+        tf_rcv_wnd_tuner firstTuner = {};
+        tf_rcv_wnd_tuner secondTuner = {};
+        tf_rcv_wnd_start(&firstTuner, first);
+        tf_rcv_wnd_start(&secondTuner, second);
+        const uint32_t base = firstTuner.wndMax;
+
+        tf_test_run_limited_epoch(&firstTuner, first);
+        XCTAssertEqual(firstTuner.wndMax, base + budget, @"capped by the budget, not doubled");
+
+        tf_test_run_limited_epoch(&secondTuner, second);
+        XCTAssertEqual(secondTuner.wndMax, base);
+        XCTAssertEqual(TCP_WND_MAX(second), base);
+
+        tf_rcv_wnd_stop(&firstTuner, first);
+        tf_test_run_limited_epoch(&secondTuner, second);
+        XCTAssertEqual(secondTuner.wndMax, base + budget);
+        XCTAssertEqual(TCP_WND_MAX(second), base + budget);
+
+        tf_rcv_wnd_stop(&secondTuner, second);
+        tcp_abort(first);
+        tcp_abort(second);
+    });
+}
+
+@end
@@ -0,0 +1,82 @@
+//
+//  ReleaseListTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFReleaseList.h"
+
+enum { kTFTestProducers = 8, kTFTestPushesPerProducer = 2000 };
+
+typedef struct {
+    tf_release_node node; // first: nodes are cast back
+    NSUInteger producer;
+    NSUInteger index;
+} tf_test_item;
+
+@interface ReleaseListTests : XCTestCase
+@end
+
+@implementation ReleaseListTests
+
+- (void)testPushReportsEmptyEdgeAndTakeReturnsOldestFirst {
+    tf_release_list list = {NULL};
+    tf_test_item items[4] = {};
+
+    XCTAssertTrue(tf_release_list_push(&list, &items[0].node), @"empty: caller drains");
+    for (NSUInteger i = 1; i < 4; i++) {
+        XCTAssertFalse(tf_release_list_push(&list, &items[i].node), @"drain already pending");
+    }
+
+    tf_release_node *node = tf_release_list_take(&list);
+    for (NSUInteger i = 0; i < 4; i++) {
+        XCTAssertEqual(node, &items[i].node);
+        node = node->next;
+    }
+    XCTAssertEqual(node, NULL);
+
+    XCTAssertEqual(tf_release_list_take(&list), NULL);
+    XCTAssertTrue(tf_release_list_push(&list, &items[0].node), @"empty again after take");
+    XCTAssertEqual(tf_release_list_take(&list), &items[0].node);
+    XCTAssertEqual(items[0].node.next, NULL);
+}
+
+/// Concurrent producers: every node arrives exactly once and each producer's pushes keep
+/// their order; exactly one push per non-empty take reports the empty edge.
+- (void)testConcurrentProducersKeepPerProducerOrder {
+    tf_release_list list = {NULL};
+    tf_test_item *items = calloc(kTFTestProducers * kTFTestPushesPerProducer, sizeof(*items));
+    atomic_uint edges = 0;
+
+    tf_release_list *shared = &list;
+    atomic_uint *sharedEdges = &edges;
+    dispatch_apply(kTFTestProducers, DISPATCH_APPLY_AUTO, ^(size_t producer) {
+        for (NSUInteger i = 0; i < kTFTestPushesPerProducer; i++) {
+            tf_test_item *item = &items[producer * kTFTestPushesPerProducer + i];
+            item->producer = producer;
+            item->index = i;
+            if (tf_release_list_push(shared, &item->node)) {
+                atomic_fetch_add(sharedEdges, 1);
+            }
+        }
+    });
+
+    XCTAssertEqual(atomic_load(&edges), 1u, @"no take in between: one empty edge");
+
+    NSUInteger next[kTFTestProducers] = {};
+    NSUInteger total = 0;
+    for (tf_release_node *node = tf_release_list_take(&list); node; node = node->next) {
+        tf_test_item *item = (tf_test_item *)node;
+        XCTAssertEqual(item->index, next[item->producer], @"producer %lu",
+                       (unsigned long)item->producer);
+        next[item->producer] = item->index + 1;
+        total++;
+    }
+    XCTAssertEqual(total, (NSUInteger)kTFTestProducers * kTFTestPushesPerProducer);
+    free(items);
+}
+
+@end
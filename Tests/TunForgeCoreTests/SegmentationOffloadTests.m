@@ -0,0 +1,171 @@
+//
+//  SegmentationOffloadTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFSegmentationOffload.h"
+#import "TFTestSupport.h"
+
+#import "lwip/def.h"
+#import "lwip/pbuf.h"
+#import "lwip/prot/tcp.h"
+
+enum { kTFTestPayloadLength = 3001, kTFTestMss = 536 };
+
+@interface SegmentationOffloadTests : XCTestCase
+@end
+
+@implementation SegmentationOffloadTests {
+    u8_t _payload[kTFTestPayloadLength];
+    u8_t _header[TF_GSO_HEADER_MAX];
+    u16_t _hdrlen;
+    u8_t _packet[TF_GSO_HEADER_MAX + kTFTestMss];
+}
+
+- (void)setUp {
+    TFTestSetUp();
+    TFTestFillBytes(_payload, sizeof(_payload), 7);
+
+    static const u8_t timestamps[12] = {1, 1, 8, 10, 0, 0, 0, 1, 0, 0, 0, 2};
+    TFTestTCPHeader header = {
+        .src = 0x0a000001,
+        .dst = 0x0a000002,
+        .sport = 443,
+        .dport = 50000,
+        .seq = 0xfffffc00, // wraps within the super-segment
+        .ack = 1,
+        .flags = TCP_ACK | TCP_PSH | TCP_FIN,
+        .wnd = 2048,
+        .ipid = 0xfffe,    // wraps too
+        .options = timestamps,
+        .optionsLength = sizeof(timestamps),
+    };
+    // lwIP leaves a super-segment's TCP checksum to the segmenter.
+    _hdrlen = TFTestBuildTCPPacket(_header, &header, NULL, 0, NO);
+}
+
+/// A super-segment as lwIP hands it to the netif: header pbuf, then the payload spread over
+/// pbufs of odd sizes so packets straddle pbuf boundaries at odd offsets.
+- (struct pbuf *)superSegment {
+    u16_t total = (u16_t)(_hdrlen + kTFTestPayloadLength);
+    u8_t ip[TF_GSO_HEADER_MAX];
+    memcpy(ip, _header, _hdrlen);
+    u16_t length = lwip_htons(total);
+    memcpy(ip + 2, &length, 2);
+    memset(ip + 10, 0, 2);
+    u16_t ipChksum = inet_chksum(ip, 20);
+    memcpy(ip + 10, &ipChksum, 2);
+
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, _hdrlen, PBUF_RAM);
+    pbuf_take(p, ip, _hdrlen);
+
+    static const u16_t pieces[] = {1, 700, 333, 1024, 943};
+    NSUInteger offset = 0;
+    for (NSUInteger i = 0; i < sizeof(pieces) / sizeof(pieces[0]); i++) {
+        struct pbuf *q = pbuf_alloc(PBUF_RAW, pieces[i], PBUF_RAM);
+        pbuf_take(q, _payload + offset, pieces[i]);
+        pbuf_cat(p, q);
+        offset += pieces[i];
+    }
+    return p;
+}
+
+#pragma mark - Tests
+
+- (void)testPlanCutsPayloadIntoMssUnits {
+    struct pbuf *p = [self superSegment];
+    tf_gso_plan plan;
+    XCTAssertTrue(tf_gso_plan_init(&plan, p, kTFTestMss));
+
+    XCTAssertEqual(plan.hdrlen, _hdrlen);
+    XCTAssertEqual(plan.payloadLength, kTFTestPayloadLength);
+    XCTAssertEqual(plan.unit, kTFTestMss - 12, @"options count against the MSS");
+    XCTAssertEqual(plan.count, (kTFTestPayloadLength + plan.unit - 1) / plan.unit);
+
+    NSUInteger covered = 0;
+    for (u16_t i = 0; i < plan.count; i++) {
+        XCTAssertEqual(tf_gso_payload_offset(&plan, i), _hdrlen + covered);
+        covered += tf_gso_payload_length(&plan, i);
+    }
+    XCTAssertEqual(covered, kTFTestPayloadLength);
+    XCTAssertEqual(tf_gso_payload_length(&plan, plan.count - 1),
+                   kTFTestPayloadLength - (plan.count - 1) * plan.unit);
+    pbuf_free(p);
+}
+
+/// Every packet must carry the checksums a full recompute gives, with only the per-packet
+/// fields changed from the template.
+- (void)testPacketsMatchFullRecompute {
+    struct pbuf *p = [self superSegment];
+    tf_gso_plan plan;
+    XCTAssertTrue(tf_gso_plan_init(&plan, p, kTFTestMss));
+
+    for (u16_t i = 0; i < plan.count; i++) {
+        u16_t payloadLength = tf_gso_payload_length(&plan, i);
+        u16_t len = (u16_t)(plan.hdrlen + payloadLength);
+        u16_t payloadSum = tf_gso_pbuf_copy_sum(
+            p, tf_gso_payload_offset(&plan, i), payloadLength, _packet + plan.hdrlen);
+        tf_gso_build_header(&plan, i, _packet, payloadSum);
+
+        const u8_t *payload = _payload + (NSUInteger)i * plan.unit;
+        XCTAssertEqual(memcmp(_packet + plan.hdrlen, payload, payloadLength), 0);
+        XCTAssertEqual(TFTestNormalizeSum(payloadSum), TFTestSum(payload, payloadLength));
+
+        u16_t ipLength, ipid;
+        u32_t seq;
+        memcpy(&ipLength, _packet + 2, 2);
+        memcpy(&ipid, _packet + 4, 2);
+        memcpy(&seq, _packet + 24, 4);
+        XCTAssertEqual(lwip_ntohs(ipLength), len);
+        XCTAssertEqual(lwip_ntohs(ipid), (u16_t)(0xfffe + i));
+        XCTAssertEqual(lwip_ntohl(seq), (u32_t)(0xfffffc00 + (u32_t)i * plan.unit));
+
+        u8_t flags = _packet[20 + 13];
+        u8_t expected = (i + 1 == plan.count) ? (TCP_ACK | TCP_PSH | TCP_FIN) : TCP_ACK;
+        XCTAssertEqual(flags, expected, @"packet %u", i);
+
+        XCTAssertTrue(TFTestIPChecksumValid(_packet), @"packet %u", i);
+        XCTAssertTrue(TFTestTCPChecksumValid(_packet, len), @"packet %u", i);
+    }
+    pbuf_free(p);
+}
+
+- (void)testPbufSumMatchesFlatSumAcrossChainBoundaries {
+    struct pbuf *p = [self superSegment];
+    static const u16_t offsets[] = {0, 1, 2, 700, 701, 1034, 2057, 3000};
+    static const u16_t lengths[] = {0, 1, 2, 3, 333, 1024, 1025};
+    for (NSUInteger o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+        for (NSUInteger l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            u16_t offset = offsets[o];
+            u16_t length = (u16_t)MIN(lengths[l], kTFTestPayloadLength - offset);
+            u16_t sum = tf_gso_pbuf_sum(p, (u16_t)(_hdrlen + offset), length);
+            XCTAssertEqual(TFTestNormalizeSum(sum),
+                           TFTestSum(_payload + offset, length),
+                           @"offset %u length %u",
+                           offset,
+                           length);
+        }
+    }
+    pbuf_free(p);
+}
+
+- (void)testRejectsUnsegmentablePackets {
+    struct pbuf *p = [self superSegment];
+    tf_gso_plan plan;
+    XCTAssertFalse(tf_gso_plan_init(&plan, p, 12), @"MSS must exceed the options");
+
+    ((u8_t *)p->payload)[9] = IP_PROTO_UDP;
+    XCTAssertFalse(tf_gso_plan_init(&plan, p, kTFTestMss));
+    pbuf_free(p);
+
+    struct pbuf *bare = pbuf_alloc(PBUF_RAW, _hdrlen, PBUF_RAM);
+    pbuf_take(bare, _header, _hdrlen);
+    XCTAssertFalse(tf_gso_plan_init(&plan, bare, kTFTestMss), @"no payload");
+    pbuf_free(bare);
+}
+
+@end
@@ -0,0 +1,191 @@
+//
+//  SendBufferTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFSendBuffer.h"
+#import "TFTestSupport.h"
+
+#import "lwip/sys.h"
+#import "lwip/tcp.h"
+
+/// Payload bytes on unsent + unacked.
+static tcpwnd_size_t tf_test_queued(const struct tcp_pcb *pcb) {
+    tcpwnd_size_t queued = 0;
+    for (const struct tcp_seg *seg = pcb->unsent; seg; seg = seg->next) {
+        queued += seg->len;
+    }
+    for (const struct tcp_seg *seg = pcb->unacked; seg; seg = seg->next) {
+        queued += seg->len;
+    }
+    return queued;
+}
+
+/// snd_buf - debt + queued: the buffer size the pcb accounts for.
+static tcpwnd_size_t tf_test_accounted(const struct tcp_pcb *pcb) {
+    return (tcpwnd_size_t)(pcb->snd_buf - pcb->tunforge_snd_buf_debt + tf_test_queued(pcb));
+}
+
+/// One ~1 s epoch in which the peer ACKs `acked` bytes, MSS by MSS.
+static void tf_test_run_epoch(tf_snd_buf_tuner *tuner,
+                              struct tcp_pcb *pcb,
+                              uint32_t acked,
+                              BOOL backlogged) {
+    while (acked > 0) {
+        uint32_t len = MIN(acked, (uint32_t)TCP_MSS);
+        tf_snd_buf_note_acked(tuner, pcb, len, backlogged);
+        acked -= len;
+    }
+    tuner->epochStartMs = sys_now() - 1000;
+    tf_snd_buf_update(tuner, pcb);
+}
+
+@interface SendBufferTests : XCTestCase
+@end
+
+@implementation SendBufferTests
+
+- (void)setUp {
+    TFTestSetUp();
+}
+
+/// Resizing with data queued must neither drop it nor lose track of it: shrinking below
+/// what is queued records debt, growing repays it first.
+- (void)testResizeKeepsQueuedBytesAccounted {
+    TFTestOnPacketsQueue(^{
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        static u8_t data[3000];
+        XCTAssertEqual(tcp_write(pcb, data, sizeof(data), TCP_WRITE_FLAG_COPY), ERR_OK);
+        XCTAssertEqual(tf_test_queued(pcb), sizeof(data));
+        XCTAssertEqual(tf_test_accounted(pcb), TCP_SND_BUF);
+
+        XCTAssertEqual(tcp_tunforge_set_snd_buf_max(pcb, 2000), 2000u);
+        XCTAssertEqual(pcb->snd_buf, 0u);
+        XCTAssertEqual(pcb->tunforge_snd_buf_debt, 1000u);
+        XCTAssertEqual(tf_test_accounted(pcb), 2000u);
+
+        XCTAssertEqual(tcp_tunforge_set_snd_buf_max(pcb, 8000), 8000u);
+        XCTAssertEqual(pcb->tunforge_snd_buf_debt, 0u);
+        XCTAssertEqual(pcb->snd_buf, 5000u);
+        XCTAssertEqual(tf_test_accounted(pcb), 8000u);
+
+        XCTAssertEqual(tcp_tunforge_set_snd_buf_max(pcb, 0), TCP_SND_BUF);
+        XCTAssertEqual(tf_test_accounted(pcb), TCP_SND_BUF);
+        XCTAssertEqual(tf_test_queued(pcb), sizeof(data));
+
+        tcp_abort(pcb);
+    });
+}
+
+- (void)testGrowsWhileWritesWaitForBuffer {
+    TFTestOnPacketsQueue(^{
+        tf_snd_buf_set_budget((NSUInteger)TCP_SND_BUF * 4);
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        tf_snd_buf_tuner tuner = {};
+        tf_snd_buf_start(&tuner, pcb);
+        const uint32_t initial = tuner.bufMax;
+        XCTAssertLessThan(initial, TCP_SND_BUF);
+        XCTAssertEqual(pcb->snd_buf, initial);
+
+        // Nothing happens before the epoch is over.
+        tf_snd_buf_update(&tuner, pcb);
+        XCTAssertEqual(tuner.bufMax, initial);
+
+        // Hardly anything ACKed, but writes were backlogged: probe upward anyway.
+        tf_test_run_epoch(&tuner, pcb, TCP_MSS, YES);
+        XCTAssertEqual(tuner.bufMax, 2 * initial);
+        XCTAssertEqual(pcb->snd_buf, 2 * initial);
+
+        tf_snd_buf_stop(&tuner, pcb);
+        XCTAssertEqual(pcb->snd_buf, TCP_SND_BUF);
+        tcp_abort(pcb);
+    });
+}
+
+/// With a 500 ms RTT, an epoch of 1 s ACKing N bytes measures a BDP of N / 2: the target is
+/// N, beyond mere doubling while limited, and between half and the full size when not.
+- (void)testTargetFollowsBandwidthDelayProduct {
+    TFTestOnPacketsQueue(^{
+        tf_snd_buf_set_budget((NSUInteger)TCP_SND_BUF * 4);
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        pcb->sa = 1 << 3; // one TCP_SLOW_INTERVAL tick
+        tf_snd_buf_tuner tuner = {};
+        tf_snd_buf_start(&tuner, pcb);
+        XCTAssertLessThan(2 * tuner.bufMax, TCP_SND_BUF);
+
+        // sys_now() may tick during an epoch: allow 1%.
+        tf_test_run_epoch(&tuner, pcb, TCP_SND_BUF, YES);
+        XCTAssertEqualWithAccuracy(tuner.bufMax, TCP_SND_BUF, TCP_SND_BUF / 100);
+
+        tf_test_run_epoch(&tuner, pcb, TCP_SND_BUF / 4 * 3, NO);
+        XCTAssertEqualWithAccuracy(tuner.bufMax, TCP_SND_BUF / 4 * 3, TCP_SND_BUF / 100);
+        XCTAssertEqual(pcb->snd_buf, tuner.bufMax);
+
+        tf_snd_buf_stop(&tuner, pcb);
+        tcp_abort(pcb);
+    });
+}
+
+- (void)testShrinksByAtMostHalf {
+    TFTestOnPacketsQueue(^{
+        tf_snd_buf_set_budget((NSUInteger)TCP_SND_BUF * 4);
+        struct tcp_pcb *pcb = TFTestEstablishedPCB();
+        tf_snd_buf_tuner tuner = {};
+        tf_snd_buf_start(&tuner, pcb);
+        const uint32_t initial = tuner.bufMax;
+        while (tuner.bufMax < TCP_SND_BUF) {
+            tf_test_run_epoch(&tuner, pcb, TCP_MSS, YES);
+        }
+
+        // Idle epochs: the measured BDP is 0, the buffer halves down to the initial size.
+        tf_test_run_epoch(&tuner, pcb, 0, NO);
+        XCTAssertEqual(tuner.bufMax, TCP_SND_BUF / 2);
+        while (tuner.bufMax > initial) {
+            const uint32_t before = tuner.bufMax;
+            tf_test_run_epoch(&tuner, pcb, 0, NO);
+            XCTAssertLessThan(tuner.bufMax, before);
+            XCTAssertGreaterThanOrEqual(tuner.bufMax, before / 2);
+        }
+        XCTAssertEqual(tuner.bufMax, initial);
+        XCTAssertEqual(pcb->snd_buf, initial);
+
+        tf_snd_buf_stop(&tuner, pcb);
+        tcp_abort(pcb);
+    });
+}
+
+/// Growth of one pcb uses up the shared budget; the other grows once it is returned.
+- (void)testBudgetCapsGrowthAcrossPcbs {
+    TFTestOnPacketsQueue(^{
+        struct tcp_pcb *first = TFTestEstablishedPCB();
+        struct tcp_pcb *second = TFTestEstablishedPCB();
+        tf_snd_buf_tuner firstTuner = {};
+        tf_snd_buf_tuner secondTuner = {};
+        tf_snd_buf_start(&firstTuner, first);
+        tf_snd_buf_start(&secondTuner, second);
+        const uint32_t initial = firstTuner.bufMax;
+        tf_snd_buf_set_budget(initial);
+
+        tf_test_run_epoch(&firstTuner, first, TCP_MSS, YES);
+        XCTAssertEqual(firstTuner.bufMax, 2 * initial);
+
+        tf_test_run_epoch(&secondTuner, second, TCP_MSS, YES);
+        XCTAssertEqual(secondTuner.bufMax, initial);
+        XCTAssertEqual(second->snd_buf, initial);
+
+        tf_snd_buf_stop(&firstTuner, first);
+        tf_test_run_epoch(&secondTuner, second, TCP_MSS, YES);
+        XCTAssertEqual(secondTuner.bufMax, 2 * initial);
+        XCTAssertEqual(second->snd_buf, 2 * initial);
+
+        tf_snd_buf_stop(&secondTuner, second);
+        tcp_abort(first);
+        tcp_abort(second);
+    });
+}
+
+@end
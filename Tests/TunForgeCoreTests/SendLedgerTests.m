@@ -0,0 +1,98 @@
+//
+//  SendLedgerTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFEgressFence.h"
+#import "TFSendLedger.h"
+#import "TFTestSupport.h"
+
+@interface SendLedgerTests : XCTestCase
+@end
+
+@implementation SendLedgerTests {
+    NSMutableArray<NSNumber *> *_released;
+}
+
+- (void)setUp {
+    TFTestSetUp();
+    _released = [NSMutableArray array];
+}
+
+/// Appends an entry that records `tag` when released.
+- (void)append:(tf_send_ledger *)ledger endSeq:(uint32_t)endSeq tag:(NSUInteger)tag {
+    XCTAssertTrue(tf_send_ledger_reserve(ledger));
+    NSMutableArray<NSNumber *> *released = _released;
+    tf_send_ledger_append(ledger, endSeq, ^{
+        [released addObject:@(tag)];
+    });
+}
+
+- (void)testAcknowledgeAcrossSequenceWrap {
+    TFTestOnPacketsQueue(^{
+        tf_send_ledger *ledger = tf_send_ledger_create();
+        [self append:ledger endSeq:0xfffffff0 tag:0];
+        [self append:ledger endSeq:0xfffffffe tag:1];
+        [self append:ledger endSeq:0x00000010 tag:2];
+        [self append:ledger endSeq:0x00000100 tag:3];
+
+        tf_send_ledger_acknowledge(ledger, 0xffffffef);
+        XCTAssertEqualObjects(self->_released, @[]);
+
+        tf_send_ledger_acknowledge(ledger, 0xfffffffe);
+        XCTAssertEqualObjects(self->_released, (@[ @0, @1 ]));
+
+        // Past the wrap lastack is numerically smaller than the released endSeqs.
+        tf_send_ledger_acknowledge(ledger, 0x00000020);
+        XCTAssertEqualObjects(self->_released, (@[ @0, @1, @2 ]));
+
+        tf_send_ledger_destroy(ledger);
+        XCTAssertEqualObjects(self->_released, (@[ @0, @1, @2, @3 ]));
+    });
+}
+
+/// Growing the ring while its head is not at index 0 must keep send order.
+- (void)testGrowthWithOffsetHeadKeepsOrder {
+    TFTestOnPacketsQueue(^{
+        tf_send_ledger *ledger = tf_send_ledger_create();
+        uint32_t seq = 1000;
+        for (NSUInteger tag = 0; tag < 8; tag++) {
+            [self append:ledger endSeq:(seq += 100) tag:tag];
+        }
+        tf_send_ledger_acknowledge(ledger, 1300);
+        XCTAssertEqualObjects(self->_released, (@[ @0, @1, @2 ]));
+
+        for (NSUInteger tag = 8; tag < 20; tag++) {
+            [self append:ledger endSeq:(seq += 100) tag:tag];
+        }
+        tf_send_ledger_acknowledge(ledger, seq);
+
+        NSMutableArray<NSNumber *> *expected = [NSMutableArray array];
+        for (NSUInteger tag = 0; tag < 20; tag++) {
+            [expected addObject:@(tag)];
+        }
+        XCTAssertEqualObjects(self->_released, expected);
+        tf_send_ledger_destroy(ledger);
+    });
+}
+
+- (void)testReleaseWaitsForOpenEgressFence {
+    TFTestOnPacketsQueue(^{
+        tf_send_ledger *ledger = tf_send_ledger_create();
+        [self append:ledger endSeq:100 tag:0];
+
+        tf_egress_fence fence = tf_egress_fence_open();
+        tf_send_ledger_acknowledge(ledger, 100);
+        XCTAssertEqualObjects(self->_released, @[], @"a batch may still read the bytes");
+
+        tf_egress_fence_close(fence);
+        XCTAssertEqualObjects(self->_released, @[ @0 ]);
+        tf_send_ledger_destroy(ledger);
+    });
+}
+
+@end
@@ -0,0 +1,96 @@
+//
+//  SplitChecksumTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFTestSupport.h"
+
+#import "lwip/def.h"
+#import "lwip/pbuf.h"
+#import "lwip/priv/tcp_priv.h"
+
+enum { kTFTestDataLength = 500 };
+
+/// seg->chksum as a normalized, unswapped folded sum.
+static u16_t tf_test_seg_sum(const struct tcp_seg *seg) {
+    u16_t sum = seg->chksum;
+    if (seg->chksum_swapped) {
+        sum = SWAP_BYTES_IN_WORD(sum);
+    }
+    return TFTestNormalizeSum(sum);
+}
+
+@interface SplitChecksumTests : XCTestCase
+@end
+
+@implementation SplitChecksumTests {
+    u8_t _data[kTFTestDataLength];
+}
+
+- (void)setUp {
+    TFTestSetUp();
+    TFTestFillBytes(_data, sizeof(_data), 11);
+}
+
+/// Splits the single unsent segment at `split` and checks both halves' checksum-on-copy
+/// sums against a full recompute over their payload.
+- (void)splitAndVerify:(struct tcp_pcb *)pcb split:(u16_t)split label:(NSString *)label {
+    if (!pcb->unsent || pcb->unsent->next) {
+        XCTFail(@"%@: expected one unsent segment before the split", label);
+        return;
+    }
+    XCTAssertEqual(tcp_split_unsent_seg(pcb, split), ERR_OK, @"%@", label);
+
+    NSUInteger offset = 0;
+    NSUInteger segments = 0;
+    for (const struct tcp_seg *seg = pcb->unsent; seg; seg = seg->next, segments++) {
+        u8_t flat[kTFTestDataLength];
+        u16_t copied = pbuf_copy_partial(seg->p, flat, seg->len, seg->p->tot_len - seg->len);
+        XCTAssertEqual(copied, seg->len, @"%@", label);
+        XCTAssertEqual(memcmp(flat, _data + offset, seg->len), 0, @"%@", label);
+
+        XCTAssertTrue(seg->flags & TF_SEG_DATA_CHECKSUMMED, @"%@", label);
+        XCTAssertEqual(tf_test_seg_sum(seg),
+                       TFTestSum(flat, seg->len),
+                       @"%@: segment at %lu, %u bytes",
+                       label,
+                       (unsigned long)offset,
+                       seg->len);
+        offset += seg->len;
+    }
+    XCTAssertEqual(segments, 2u, @"%@", label);
+    XCTAssertEqual(offset, kTFTestDataLength, @"%@", label);
+}
+
+- (void)testSplitKeepsChecksumsAtOddAndEvenOffsets {
+    static const u16_t splits[] = {1, 2, 3, 250, 251, 499};
+    for (NSUInteger i = 0; i < sizeof(splits) / sizeof(splits[0]); i++) {
+        for (NSUInteger chained = 0; chained < 2; chained++) {
+            TFTestOnPacketsQueue(^{
+                struct tcp_pcb *pcb = TFTestEstablishedPCB();
+                pcb->mss = TCP_MSS;
+                if (chained) {
+                    // A by-reference pbuf followed by a copied one in the same segment.
+                    XCTAssertEqual(tcp_write(pcb, self->_data, 201, 0), ERR_OK);
+                    XCTAssertEqual(tcp_write(pcb, self->_data + 201, kTFTestDataLength - 201,
+                                             TCP_WRITE_FLAG_COPY),
+                                   ERR_OK);
+                } else {
+                    XCTAssertEqual(tcp_write(pcb, self->_data, kTFTestDataLength,
+                                             TCP_WRITE_FLAG_COPY),
+                                   ERR_OK);
+                }
+                NSString *label = [NSString stringWithFormat:@"split %u%@", splits[i],
+                                                             chained ? @" chained" : @""];
+                [self splitAndVerify:pcb split:splits[i] label:label];
+                tcp_abort(pcb);
+            });
+        }
+    }
+}
+
+@end
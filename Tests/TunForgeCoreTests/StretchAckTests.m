@@ -0,0 +1,152 @@
+//
+//  StretchAckTests.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TFTestSupport.h"
+
+#import "lwip/ip.h"
+#import "lwip/netif.h"
+#import "lwip/priv/tcp_priv.h"
+#import "lwip/tcp.h"
+
+enum { kTFTestAckEverySegs = 8 };
+
+// packetsQueue only.
+static struct netif tf_test_netif;
+static NSUInteger tf_test_packets_out;
+
+static err_t tf_test_netif_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr) {
+    tf_test_packets_out++;
+    return ERR_OK;
+}
+
+static err_t tf_test_netif_init(struct netif *netif) {
+    netif->mtu = 1500;
+    netif->output = tf_test_netif_output;
+    return ERR_OK;
+}
+
+/// An established pcb routed through tf_test_netif and registered active, so batch end
+/// finds it.
+static struct tcp_pcb *tf_test_routed_pcb(void) {
+    struct tcp_pcb *pcb = TFTestEstablishedPCB();
+    IP_ADDR4(&pcb->local_ip, 10, 9, 0, 1);
+    IP_ADDR4(&pcb->remote_ip, 10, 9, 0, 2);
+    pcb->local_port = 80;
+    pcb->remote_port = 5000;
+    TCP_REG_ACTIVE(pcb);
+    return pcb;
+}
+
+/// What tcp_input does for an in-order segment of `len` bytes.
+static void tf_test_receive(struct tcp_pcb *pcb, u32_t len, BOOL push) {
+    pcb->rcv_nxt += len;
+    pcb->rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd - len);
+    tcp_update_rcv_ann_wnd(pcb);
+    tcp_tunforge_ack(pcb, len, push);
+    if (!tcp_tunforge_defer_output(pcb)) {
+        tcp_output(pcb);
+    }
+}
+
+static BOOL tf_test_ack_delayed(const struct tcp_pcb *pcb) {
+    return (pcb->flags & (TF_ACK_DELAY | TF_ACK_NOW)) == TF_ACK_DELAY;
+}
+
+static BOOL tf_test_ack_now(const struct tcp_pcb *pcb) {
+    return (pcb->flags & TF_ACK_NOW) != 0;
+}
+
+@interface StretchAckTests : XCTestCase
+@end
+
+@implementation StretchAckTests
+
+- (void)setUp {
+    TFTestOnPacketsQueue(^{
+        ip4_addr_t ip, mask, gw;
+        IP4_ADDR(&ip, 10, 9, 0, 1);
+        IP4_ADDR(&mask, 255, 255, 255, 0);
+        IP4_ADDR(&gw, 0, 0, 0, 0);
+        netif_add(&tf_test_netif, &ip, &mask, &gw, NULL, tf_test_netif_init, ip_input);
+        netif_set_up(&tf_test_netif);
+        netif_set_link_up(&tf_test_netif);
+        tcp_tunforge_set_ack_policy(kTFTestAckEverySegs, 0);
+        tf_test_packets_out = 0;
+    });
+}
+
+- (void)tearDown {
+    TFTestOnPacketsQueue(^{
+        tcp_tunforge_set_ack_policy(0, 0);
+        netif_remove(&tf_test_netif);
+    });
+}
+
+- (void)testStretchedAckIsForcedOutAtBatchEnd {
+    TFTestOnPacketsQueue(^{
+        struct tcp_pcb *pcb = tf_test_routed_pcb();
+
+        tcp_tunforge_batch_begin();
+        for (NSUInteger i = 0; i < kTFTestAckEverySegs - 1; i++) {
+            tf_test_receive(pcb, pcb->mss, NO);
+            XCTAssertTrue(tf_test_ack_delayed(pcb), @"segment %lu", (unsigned long)i);
+        }
+        XCTAssertEqual(tf_test_packets_out, 0u);
+        tcp_tunforge_batch_end();
+
+        XCTAssertEqual(tf_test_packets_out, 1u, @"one ACK for the whole batch");
+        XCTAssertEqual(pcb->flags & (TF_ACK_DELAY | TF_ACK_NOW), 0);
+
+        tcp_abort(pcb);
+    });
+}
+
+- (void)testPushIsAcknowledgedImmediately {
+    TFTestOnPacketsQueue(^{
+        struct tcp_pcb *pcb = tf_test_routed_pcb();
+
+        tcp_tunforge_batch_begin();
+        tf_test_receive(pcb, pcb->mss, NO);
+        XCTAssertTrue(tf_test_ack_delayed(pcb));
+        tf_test_receive(pcb, 100, YES);
+        XCTAssertTrue(tf_test_ack_now(pcb));
+        tcp_tunforge_batch_end();
+
+        XCTAssertEqual(tf_test_packets_out, 1u);
+
+        tcp_abort(pcb);
+    });
+}
+
+/// The application stopped reading: only 4 MSS of window are left, and once the peer has
+/// used more than half of that the ACK cannot wait for the segment count.
+- (void)testNearlyUsedUpWindowIsAcknowledgedImmediately {
+    TFTestOnPacketsQueue(^{
+        struct tcp_pcb *pcb = tf_test_routed_pcb();
+        tcpwnd_size_t held = (tcpwnd_size_t)(pcb->rcv_wnd - 4 * pcb->mss);
+        pcb->rcv_nxt += held;
+        pcb->rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd - held);
+
+        tcp_tunforge_batch_begin();
+        tf_test_receive(pcb, pcb->mss, NO);
+        XCTAssertTrue(tf_test_ack_delayed(pcb));
+        tf_test_receive(pcb, pcb->mss, NO);
+        XCTAssertTrue(tf_test_ack_delayed(pcb), @"half the window left");
+        tf_test_receive(pcb, pcb->mss, NO);
+        XCTAssertTrue(tf_test_ack_now(pcb), @"a quarter left, 3 of %d segments",
+                      kTFTestAckEverySegs);
+        tcp_tunforge_batch_end();
+
+        XCTAssertEqual(tf_test_packets_out, 1u);
+
+        tcp_abort(pcb);
+    });
+}
+
+@end
@@ -0,0 +1,64 @@
+//
+//  TFTestSupport.h
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "lwip/arch.h"
+
+struct tcp_pcb;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Configures TFGlobalScheduler and creates TFIPStack.defaultStack, which initializes lwIP
+/// (the stack is not started). Once per test process.
+void TFTestSetUp(void);
+
+/// Runs `block` synchronously on packetsQueue.
+void TFTestOnPacketsQueue(dispatch_block_t block);
+
+/// A pcb forced into ESTABLISHED with the full default receive window announced (window
+/// scaling on where built in), not bound to any netif: output fails to route and is
+/// dropped. Release with tcp_abort(). packetsQueue only.
+struct tcp_pcb *TFTestEstablishedPCB(void);
+
+/// Deterministic pseudo-random bytes (xorshift) so failures reproduce.
+void TFTestFillBytes(u8_t *bytes, NSUInteger count, uint64_t seed);
+
+/// Folded one's complement sum of `len` bytes, 0xffff normalized to 0 so equal sums compare
+/// equal however they were accumulated.
+u16_t TFTestSum(const void *bytes, u16_t len);
+u16_t TFTestNormalizeSum(u16_t sum);
+
+typedef struct {
+    u32_t src; // host order
+    u32_t dst;
+    u16_t sport;
+    u16_t dport;
+    u32_t seq;
+    u32_t ack;
+    u8_t flags;
+    u16_t wnd;
+    u16_t ipid;
+    const u8_t *_Nullable options; // multiple of 4 bytes
+    u8_t optionsLength;
+} TFTestTCPHeader;
+
+/// Writes a complete IPv4/TCP packet with valid checksums (TCP checksum 0 if `!tcpChecksum`);
+/// returns its length.
+u16_t TFTestBuildTCPPacket(u8_t *out,
+                           const TFTestTCPHeader *header,
+                           const u8_t *_Nullable payload,
+                           u16_t payloadLength,
+                           BOOL tcpChecksum);
+
+/// YES if the IPv4 header checksum of `packet` verifies.
+BOOL TFTestIPChecksumValid(const u8_t *packet);
+
+/// YES if the TCP checksum of the IPv4 `packet` (pseudo header included) verifies.
+BOOL TFTestTCPChecksumValid(const u8_t *packet, u16_t len);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,151 @@
+//
+//  TFTestSupport.m
+//  TunForge
+//
+//  Created by MagicianQuinn on 2026/10/17.
+//
+
+#import "TFTestSupport.h"
+#import "TFGlobalScheduler.h"
+#import "TFIPStack.h"
+#import "TFQueueHelpers.h"
+
+#import "lwip/def.h"
+#import "lwip/inet_chksum.h"
+#import "lwip/prot/ip.h"
+#import "lwip/tcp.h"
+
+enum { kTFTestIPHeaderLength = 20, kTFTestTCPHeaderLength = 20 };
+
+void TFTestSetUp(void) {
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        dispatch_queue_t packetsQueue =
+            dispatch_queue_create("tunforge.tests.packets", DISPATCH_QUEUE_SERIAL);
+        dispatch_queue_t connectionsQueue =
+            dispatch_queue_create("tunforge.tests.connections", DISPATCH_QUEUE_SERIAL);
+        TFBindQueueSpecific(packetsQueue, TFGetPacketsQueueKey(), (void *)1);
+        TFBindQueueSpecific(connectionsQueue, TFGetConnectionsQueueKey(), (void *)1);
+        [TFGlobalScheduler.shared configureWithPacketsQueue:packetsQueue
+                                           connectionsQueue:connectionsQueue];
+        // Its init runs lwip_init(): creating the stack later would reset lwIP under live pcbs.
+        (void)[TFIPStack defaultStack];
+    });
+}
+
+void TFTestOnPacketsQueue(dispatch_block_t block) {
+    TFTestSetUp();
+    dispatch_sync(TFGlobalScheduler.shared.packetsQueue, block);
+}
+
+struct tcp_pcb *TFTestEstablishedPCB(void) {
+    TF_ASSERT_ON_PACKETS_QUEUE();
+
+    struct tcp_pcb *pcb = tcp_new();
+    pcb->state = ESTABLISHED;
+#if LWIP_WND_SCALE
+    tcp_set_flags(pcb, TF_WND_SCALE);
+    pcb->rcv_scale = TCP_RCV_SCALE;
+    pcb->snd_scale = TCP_RCV_SCALE;
+#endif
+    pcb->rcv_wnd = pcb->rcv_ann_wnd = TCP_WND_MAX(pcb);
+    pcb->rcv_nxt = 1000;
+    pcb->rcv_ann_right_edge = pcb->rcv_nxt + pcb->rcv_wnd;
+    pcb->snd_wnd = pcb->snd_wnd_max = TCP_WND;
+    return pcb;
+}
+
+void TFTestFillBytes(u8_t *bytes, NSUInteger count, uint64_t seed) {
+    uint64_t state = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    for (NSUInteger i = 0; i < count; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bytes[i] = (u8_t)state;
+    }
+}
+
+u16_t TFTestNormalizeSum(u16_t sum) {
+    return sum == 0xffff ? 0 : sum;
+}
+
+u16_t TFTestSum(const void *bytes, u16_t len) {
+    return TFTestNormalizeSum((u16_t)~inet_chksum(bytes, len));
+}
+
+static void tf_test_put16(u8_t *p, u16_t v) {
+    p[0] = (u8_t)(v >> 8);
+    p[1] = (u8_t)v;
+}
+
+static void tf_test_put32(u8_t *p, u32_t v) {
+    tf_test_put16(p, (u16_t)(v >> 16));
+    tf_test_put16(p + 2, (u16_t)v);
+}
+
+/// Folded sum of pseudo header + TCP segment.
+static u16_t tf_test_tcp_sum(const u8_t *packet, u16_t len) {
+    u16_t tcplen = (u16_t)(len - kTFTestIPHeaderLength);
+    u8_t pseudo[12];
+    memcpy(pseudo, packet + 12, 8);
+    pseudo[8] = 0;
+    pseudo[9] = IP_PROTO_TCP;
+    tf_test_put16(pseudo + 10, tcplen);
+
+    u32_t acc = (u16_t)~inet_chksum(pseudo, sizeof(pseudo));
+    u16_t segment = (u16_t)~inet_chksum(packet + kTFTestIPHeaderLength, tcplen);
+    acc += segment;
+    acc = FOLD_U32T(acc);
+    return (u16_t)FOLD_U32T(acc);
+}
+
+u16_t TFTestBuildTCPPacket(u8_t *out,
+                           const TFTestTCPHeader *header,
+                           const u8_t *payload,
+                           u16_t payloadLength,
+                           BOOL tcpChecksum) {
+    u16_t tcphlen = (u16_t)(kTFTestTCPHeaderLength + header->optionsLength);
+    u16_t len = (u16_t)(kTFTestIPHeaderLength + tcphlen + payloadLength);
+    memset(out, 0, kTFTestIPHeaderLength + tcphlen);
+
+    // IPv4, no options, DF
+    out[0] = 0x45;
+    tf_test_put16(out + 2, len);
+    tf_test_put16(out + 4, header->ipid);
+    out[6] = 0x40;
+    out[8] = 64;
+    out[9] = IP_PROTO_TCP;
+    tf_test_put32(out + 12, header->src);
+    tf_test_put32(out + 16, header->dst);
+    u16_t ipChksum = inet_chksum(out, kTFTestIPHeaderLength);
+    memcpy(out + 10, &ipChksum, 2);
+
+    u8_t *tcp = out + kTFTestIPHeaderLength;
+    tf_test_put16(tcp, header->sport);
+    tf_test_put16(tcp + 2, header->dport);
+    tf_test_put32(tcp + 4, header->seq);
+    tf_test_put32(tcp + 8, header->ack);
+    tcp[12] = (u8_t)((tcphlen / 4) << 4);
+    tcp[13] = header->flags;
+    tf_test_put16(tcp + 14, header->wnd);
+    if (header->optionsLength) {
+        memcpy(tcp + kTFTestTCPHeaderLength, header->options, header->optionsLength);
+    }
+    if (payloadLength) {
+        memcpy(tcp + tcphlen, payload, payloadLength);
+    }
+
+    if (tcpChecksum) {
+        u16_t tcpChksum = (u16_t)~tf_test_tcp_sum(out, len);
+        memcpy(tcp + 16, &tcpChksum, 2);
+    }
+    return len;
+}
+
+BOOL TFTestIPChecksumValid(const u8_t *packet) {
+    return inet_chksum(packet, kTFTestIPHeaderLength) == 0;
+}
+
+BOOL TFTestTCPChecksumValid(const u8_t *packet, u16_t len) {
+    return TFTestNormalizeSum(tf_test_tcp_sum(packet, len)) == 0;
+}
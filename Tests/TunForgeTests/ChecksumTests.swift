@@ -0,0 +1,119 @@
+import Foundation
+import Lwip
+import Testing
+
+/// Vectorized LWIP_CHKSUM kernels (tf_chksum.c) against lwIP's scalar algorithm #2.
+@Suite struct ChecksumTests {
+    static let kernels = [
+        TF_CHKSUM_KERNEL_SCALAR,
+        TF_CHKSUM_KERNEL_NEON,
+        TF_CHKSUM_KERNEL_SSE2,
+        TF_CHKSUM_KERNEL_AVX2,
+    ].filter { tf_chksum_kernel_available($0) != 0 }
+
+    /// Deterministic pseudo-random bytes (xorshift) so failures reproduce.
+    static func bytes(_ count: Int, seed: UInt64 = 0x9E37_79B9_7F4A_7C15) -> [UInt8] {
+        var state = seed
+        return (0..<count).map { _ in
+            state ^= state << 13
+            state ^= state >> 7
+            state ^= state << 17
+            return UInt8(truncatingIfNeeded: state)
+        }
+    }
+
+    static func check(_ buffer: UnsafeRawPointer, _ length: Int) {
+        let reference = lwip_standard_chksum(buffer, Int32(length))
+        for kernel in kernels {
+            let name = String(cString: tf_chksum_kernel_name(kernel))
+            #expect(
+                tf_chksum_kernel(kernel, buffer, Int32(length)) == reference,
+                "\(name) length \(length)"
+            )
+        }
+        #expect(tf_chksum(buffer, Int32(length)) == reference, "dispatch length \(length)")
+    }
+
+    @Test func matchesScalarOverOddLengthsAndAlignments() {
+        let data = Self.bytes(64 + 1600)
+        data.withUnsafeBytes { raw in
+            for alignment in 0..<64 {
+                for length in 0..<1600 {
+                    Self.check(raw.baseAddress! + alignment, length)
+                }
+            }
+        }
+    }
+
+    /// lwIP's algorithm #2 is only defined up to 0x20000 bytes.
+    @Test func matchesScalarOnLargeAndSaturatedBuffers() {
+        let random = Self.bytes(0x20000 + 3)
+        let ones = [UInt8](repeating: 0xFF, count: 0x20000 + 3)
+        let zeros = [UInt8](repeating: 0, count: 4096 + 3)
+        for buffer in [random, ones, zeros] {
+            let lengths = [buffer.count - 3, 65535, 65536, 9000, 4095, 127, 63]
+            buffer.withUnsafeBytes { raw in
+                for length in lengths where length <= buffer.count - 3 {
+                    for alignment in 0..<3 {
+                        Self.check(raw.baseAddress! + alignment, length)
+                    }
+                }
+            }
+        }
+    }
+
+    /// LWIP_CHKSUM_COPY: copies exactly `length` bytes and returns the reference sum.
+    @Test func copyAndSumMatchesScalarAndCopiesExactly() {
+        let data = Self.bytes(8 + 1600)
+        var target = [UInt8](repeating: 0, count: 8 + 1600 + 8)
+        data.withUnsafeBytes { source in
+            target.withUnsafeMutableBytes { destination in
+                for alignment in 0..<8 {
+                    for length in 0..<1600 {
+                        let src = source.baseAddress! + alignment
+                        let dst = destination.baseAddress! + (7 - alignment)
+                        let reference = lwip_standard_chksum(src, Int32(length))
+                        func verify(_ name: String, _ copy: () -> UInt16) {
+                            memset(destination.baseAddress!, 0xA5, destination.count)
+                            #expect(copy() == reference, "\(name) length \(length)")
+                            #expect(memcmp(dst, src, length) == 0, "\(name) length \(length)")
+                            #expect(dst.load(fromByteOffset: length, as: UInt8.self) == 0xA5)
+                        }
+                        for kernel in Self.kernels {
+                            verify(String(cString: tf_chksum_kernel_name(kernel))) {
+                                tf_chksum_copy_kernel(kernel, dst, src, Int32(length))
+                            }
+                        }
+                        verify("dispatch") { tf_chksum_copy(dst, src, UInt16(length)) }
+                    }
+                }
+            }
+        }
+    }
+
+    /// Microbenchmark; reports throughput per kernel and length, asserts only agreement.
+    /// Opt in with TUNFORGE_BENCHMARK=1 so the default suite stays fast.
+    @Test(.enabled(if: ProcessInfo.processInfo.environment["TUNFORGE_BENCHMARK"] != nil))
+    func throughput() {
+        let data = Self.bytes(65536 + 1)
+        data.withUnsafeBytes { raw in
+            for length in [20, 1500, 65535] {
+                let iterations = max(1, 64_000_000 / (length + 64))
+                let tail = raw.baseAddress! + ((iterations - 1) & 1)
+                let reference = lwip_standard_chksum(tail, Int32(length))
+                for kernel in Self.kernels {
+                    var last: UInt16 = 0
+                    let start = DispatchTime.now().uptimeNanoseconds
+                    for i in 0..<iterations {
+                        last = tf_chksum_kernel(kernel, raw.baseAddress! + (i & 1), Int32(length))
+                    }
+                    let nanoseconds = DispatchTime.now().uptimeNanoseconds - start
+                    let rate = Double(iterations * length) / Double(max(nanoseconds, 1))
+                    let name = String(cString: tf_chksum_kernel_name(kernel))
+                    print("tf_chksum \(name) \(length)B: \(String(format: "%.2f", rate)) GB/s")
+                    #expect(last == reference)
+                }
+            }
+        }
+    }
+}